@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Model.hpp"
+#include "NeighbourCount.hpp"
+#include "Options.hpp"
+#ifdef MINESWEEPER_BENCH_VIEW
+#include "View.hpp"
+#endif
+
+namespace {
+constexpr auto f_defaultSeed{0x5eedULL};
+constexpr auto f_presetIterations{2000};
+constexpr auto f_largeIterations{20};
+constexpr auto f_hugeIterations{5};
+constexpr auto f_revealIterations{20};
+constexpr auto f_chordIterations{200};
+constexpr auto f_viewIterations{100};
+constexpr auto f_largeSide{1000};
+constexpr auto f_hugeSide{4096};
+constexpr auto f_chordSide{64};
+constexpr auto f_minesDensity{.15};
+constexpr auto f_viewWidth{1920u};
+constexpr auto f_viewHeight{1080u};
+constexpr int f_kernelSides[]{1, 2, 3, 15, 16, 17, 31, 33, 64, 100, 1023};
+
+std::atomic<long long> f_allocations{0};
+
+struct Result {
+  std::string name;
+  int iterations;
+  double meanNs;
+  double minNs;
+  double allocations;
+};
+
+template <typename Setup, typename Run>
+Result measure(const std::string &name, int iterations, Setup setup, Run run) {
+  Result result{name, iterations, 0., std::numeric_limits<double>::max(), 0.};
+  auto allocations{0LL};
+  for (auto i = 0; i < iterations; i++) {
+    setup(i);
+    auto allocationsBefore{f_allocations.load(std::memory_order_relaxed)};
+    auto start{std::chrono::steady_clock::now()};
+    run(i);
+    auto end{std::chrono::steady_clock::now()};
+    allocations +=
+        f_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+    auto ns{std::chrono::duration<double, std::nano>(end - start).count()};
+    result.meanNs += ns;
+    result.minNs = std::min(result.minNs, ns);
+  }
+  result.meanNs /= iterations;
+  result.allocations = static_cast<double>(allocations) / iterations;
+  std::fprintf(stderr, "%-24s %12.0f ns %12.0f ns min %8.1f allocs\n",
+               name.c_str(), result.meanNs, result.minNs, result.allocations);
+  return result;
+}
+
+inline int customMinesCount(int width, int height) {
+  return static_cast<int>(width * height * f_minesDensity);
+}
+
+inline std::pair<int, int> findMine(const Model &model) {
+  for (auto row = 0; row < model.height(); row++) {
+    for (auto col = 0; col < model.width(); col++) {
+      if (model.cell(col, row).type() == Cell::Type::Mine &&
+          model.cell(col, row).status() == Cell::Status::Hidden) {
+        return {col, row};
+      }
+    }
+  }
+  return {-1, -1};
+}
+
+void benchRestart(std::vector<Result> &results, std::uint64_t seed) {
+  const char *presets[]{"restart_9x9", "restart_16x16", "restart_30x16"};
+  Model model;
+  for (auto preset : presets) {
+    model.cycleSize();
+    results.push_back(measure(
+        preset, f_presetIterations, [](int) {},
+        [&](int i) { model.restart(seed + i); }));
+  }
+  model.setCustomSize(f_largeSide, f_largeSide,
+                      customMinesCount(f_largeSide, f_largeSide));
+  results.push_back(measure(
+      "restart_1000x1000", f_largeIterations, [](int) {},
+      [&](int i) { model.restart(seed + i); }));
+  model.setCustomSize(f_hugeSide, f_hugeSide,
+                      customMinesCount(f_hugeSide, f_hugeSide));
+  results.push_back(measure(
+      "restart_4096x4096", f_hugeIterations, [](int) {},
+      [&](int i) { model.restart(seed + i); }));
+}
+
+void benchReveal(std::vector<Result> &results, std::uint64_t seed) {
+  Model model;
+  model.setCustomSize(f_largeSide, f_largeSide, 0);
+  results.push_back(measure(
+      "reveal_opening_1000x1000", f_revealIterations,
+      [&](int i) { model.restart(seed + i); },
+      [&](int) { model.reveal(f_largeSide / 2, f_largeSide / 2); }));
+}
+
+void benchChord(std::vector<Result> &results, std::uint64_t seed) {
+  Model model;
+  model.setCustomSize(f_chordSide, f_chordSide, 1);
+  auto col{0};
+  auto row{0};
+  results.push_back(measure(
+      "chord_opening_64x64", f_chordIterations,
+      [&](int i) {
+        model.restart(seed + i);
+        auto mine{findMine(model)};
+        col = mine.first > 0 ? mine.first - 1 : mine.first + 1;
+        row = mine.second;
+        model.reveal(col, row);
+        model.cycleCellStatus(mine.first, mine.second);
+      },
+      [&](int) { model.tryRevealNeighbours(col, row); }));
+}
+
+void benchRevealAllMines(std::vector<Result> &results, std::uint64_t seed) {
+  Model model;
+  model.setCustomSize(f_largeSide, f_largeSide,
+                      customMinesCount(f_largeSide, f_largeSide));
+  results.push_back(measure(
+      "reveal_all_mines_1000x1000", f_largeIterations,
+      [&](int i) {
+        model.restart(seed + i);
+        model.reveal(0, 0);
+        auto mine{findMine(model)};
+        model.reveal(mine.first, mine.second);
+      },
+      [&](int) { model.update(); }));
+}
+
+#ifdef MINESWEEPER_BENCH_VIEW
+void benchView(std::vector<Result> &results, std::uint64_t seed) {
+  sf::RenderTexture texture;
+  if (!texture.create(f_viewWidth, f_viewHeight)) {
+    std::fprintf(stderr, "cannot create off-screen target\n");
+    return;
+  }
+  Model model;
+  model.restart(seed);
+  model.reveal(model.width() / 2, model.height() / 2);
+  View view{texture, model};
+  results.push_back(measure(
+      "view_update_30x16", f_viewIterations, [](int) {},
+      [&](int) { view.update(); }));
+}
+#endif
+
+// Runs the dispatched and the scalar neighbour count kernels on random
+// planes of every size pair in f_kernelSides, at several mine densities.
+bool checkNeighbourCount(std::uint64_t seed) {
+  std::mt19937_64 rng{seed};
+  std::vector<std::uint8_t> mines;
+  std::vector<std::uint8_t> counts;
+  std::vector<std::uint8_t> scalarCounts;
+  for (auto width : f_kernelSides) {
+    for (auto height : f_kernelSides) {
+      for (auto density : {0., f_minesDensity, .5, 1.}) {
+        std::bernoulli_distribution mine{density};
+        auto stride{width + 2};
+        mines.assign(static_cast<std::size_t>(stride) * (height + 2), 0);
+        for (auto row = 1; row <= height; row++) {
+          for (auto col = 1; col <= width; col++) {
+            mines[row * stride + col] = mine(rng);
+          }
+        }
+        auto size{static_cast<std::size_t>(width) * height};
+        counts.assign(size, 0xFF);
+        scalarCounts.assign(size, 0xFF);
+        countNeighbourMines(mines.data(), width, height, counts.data());
+        countNeighbourMinesScalar(mines.data(), width, height,
+                                  scalarCounts.data());
+        if (counts != scalarCounts) {
+          std::fprintf(stderr, "neighbour count mismatch at %dx%d\n", width,
+                       height);
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+void writeJson(std::ostream &stream, const std::vector<Result> &results) {
+  stream << "{\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const auto &result{results[i]};
+    stream << (i > 0 ? ",\n" : "\n") << "    {\"name\": \"" << result.name
+           << "\", \"iterations\": " << result.iterations
+           << ", \"mean_ns\": " << result.meanNs
+           << ", \"min_ns\": " << result.minNs
+           << ", \"allocations\": " << result.allocations << "}";
+  }
+  stream << "\n  ]\n}\n";
+}
+} // namespace
+
+void *operator new(std::size_t size) {
+  f_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto pointer{std::malloc(size > 0 ? size : 1)}) {
+    return pointer;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+int main(int argc, char *argv[]) {
+  auto options{parseOptions(argc, argv)};
+  auto seed{options.hasSeed ? options.seed : f_defaultSeed};
+  if (!checkNeighbourCount(seed)) {
+    return 1;
+  }
+  std::vector<Result> results;
+  benchRestart(results, seed);
+  benchReveal(results, seed);
+  benchChord(results, seed);
+  benchRevealAllMines(results, seed);
+#ifdef MINESWEEPER_BENCH_VIEW
+  benchView(results, seed);
+#endif
+  if (options.output.empty()) {
+    writeJson(std::cout, results);
+    return 0;
+  }
+  std::ofstream file{options.output};
+  if (!file) {
+    std::fprintf(stderr, "cannot open %s\n", options.output.c_str());
+    return 1;
+  }
+  writeJson(file, results);
+  return 0;
+}
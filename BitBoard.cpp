@@ -0,0 +1,124 @@
+#include "BitBoard.hpp"
+
+#include <bitset>
+#include <utility>
+
+namespace {
+inline int popcount(std::uint64_t word) {
+  return static_cast<int>(std::bitset<64>{word}.count());
+}
+} // namespace
+
+BitBoard::BitBoard()
+    : m_width{0}, m_height{0}, m_planeSize{0}, m_words{},
+      m_neighbourMinesCounts{}, m_file{}, m_planes{nullptr},
+      m_counts{nullptr} {}
+
+Cell BitBoard::cell(int index) const {
+  Cell cell;
+  cell.setNeighbourMinesCount(m_counts[index]);
+  if (test(Mines, index)) {
+    cell.setType(Cell::Type::Mine);
+  }
+  if (test(Revealed, index)) {
+    cell.setStatus(Cell::Status::Revealed);
+  } else if (test(Flagged, index)) {
+    cell.setStatus(Cell::Status::MarkedAsMine);
+  } else if (test(Suspected, index)) {
+    cell.setStatus(Cell::Status::MarkedAsSuspect);
+  }
+  cell.setTriggered(test(Triggered, index));
+  return cell;
+}
+
+void BitBoard::setCell(int index, Cell cell) {
+  m_counts[index] = static_cast<std::uint8_t>(cell.neighbourMinesCount());
+  assign(Mines, index, cell.type() == Cell::Type::Mine);
+  assign(Revealed, index, cell.status() == Cell::Status::Revealed);
+  assign(Flagged, index, cell.status() == Cell::Status::MarkedAsMine);
+  assign(Suspected, index, cell.status() == Cell::Status::MarkedAsSuspect);
+  assign(Triggered, index, cell.triggered());
+}
+
+void BitBoard::reset(int width, int height) {
+  m_width = width;
+  m_height = height;
+  m_planeSize = (size() + 63) / 64;
+  m_words.assign(static_cast<std::size_t>(m_planeSize) * PlanesCount, 0);
+  m_neighbourMinesCounts.assign(static_cast<std::size_t>(size()), 0);
+  m_file.close();
+  m_planes = m_words.data();
+  m_counts = m_neighbourMinesCounts.data();
+}
+
+int BitBoard::minesCount() const {
+  auto mines{plane(Mines)};
+  auto count{0};
+  for (auto i = 0; i < m_planeSize; i++) {
+    count += popcount(mines[i]);
+  }
+  return count;
+}
+
+int BitBoard::flagsCount() const {
+  auto flagged{plane(Flagged)};
+  auto count{0};
+  for (auto i = 0; i < m_planeSize; i++) {
+    count += popcount(flagged[i]);
+  }
+  return count;
+}
+
+int BitBoard::revealedSafeCellsCount() const {
+  auto mines{plane(Mines)};
+  auto revealed{plane(Revealed)};
+  auto count{0};
+  for (auto i = 0; i < m_planeSize; i++) {
+    count += popcount(revealed[i] & ~mines[i]);
+  }
+  return count;
+}
+
+bool BitBoard::allSafeCellsRevealed() const {
+  auto mines{plane(Mines)};
+  auto revealed{plane(Revealed)};
+  auto count{0};
+  for (auto i = 0; i < m_planeSize; i++) {
+    count += popcount(mines[i] | revealed[i]);
+  }
+  return count == size();
+}
+
+void BitBoard::store(std::ostream &stream) const {
+  stream.write(reinterpret_cast<const char *>(m_planes),
+               static_cast<std::streamsize>(m_planeSize) * PlanesCount *
+                   static_cast<std::streamsize>(sizeof(std::uint64_t)));
+  stream.write(reinterpret_cast<const char *>(m_counts), size());
+}
+
+bool BitBoard::load(MappedFile file, std::size_t offset, BoardLayout layout,
+                    int width, int height) {
+  if (file.size() < offset + boardStorageSize(layout, width, height)) {
+    return false;
+  }
+  if (layout == BoardLayout::Cells) {
+    reset(width, height);
+    for (auto index = 0; index < size(); index++) {
+      setCell(index, Cell{file.data()[offset + index]});
+    }
+    return true;
+  }
+  if (offset % sizeof(std::uint64_t) != 0) {
+    return false;
+  }
+  m_width = width;
+  m_height = height;
+  m_planeSize = (size() + 63) / 64;
+  m_words = {};
+  m_neighbourMinesCounts = {};
+  m_file = std::move(file);
+  m_planes = reinterpret_cast<std::uint64_t *>(m_file.data() + offset);
+  m_counts = reinterpret_cast<std::uint8_t *>(m_planes + m_planeSize *
+                                                             PlanesCount);
+  return true;
+}
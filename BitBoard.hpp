@@ -0,0 +1,116 @@
+#ifndef MINESWEEPER_BIT_BOARD_HPP
+#define MINESWEEPER_BIT_BOARD_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "BoardLayout.hpp"
+#include "Cell.hpp"
+#include "MappedFile.hpp"
+
+// Stores the board as packed 64-bit planes, one bit per cell, so bulk queries
+// and updates run one word at a time. Same interface as Board. A loaded board
+// works directly on the planes of the mapped file.
+class BitBoard {
+public:
+  static constexpr BoardLayout layout{BoardLayout::Planes};
+
+  BitBoard();
+
+  BitBoard(const BitBoard &) = delete;
+  BitBoard &operator=(const BitBoard &) = delete;
+  BitBoard(BitBoard &&) = default;
+  BitBoard &operator=(BitBoard &&) = default;
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+  int size() const { return m_width * m_height; }
+  bool empty() const { return size() == 0; }
+
+  int index(int col, int row) const { return row * m_width + col; }
+  int col(int index) const { return index % m_width; }
+  int row(int index) const { return index / m_width; }
+  bool contains(int col, int row) const {
+    return col >= 0 && col < m_width && row >= 0 && row < m_height;
+  }
+
+  Cell cell(int index) const;
+  Cell cell(int col, int row) const { return cell(index(col, row)); }
+  void setCell(int index, Cell cell);
+
+  void reset(int width, int height);
+  template <typename Record> void revealAllMines(Record record);
+  int minesCount() const;
+  int flagsCount() const;
+  int revealedSafeCellsCount() const;
+  bool allSafeCellsRevealed() const;
+
+  void store(std::ostream &stream) const;
+  bool load(MappedFile file, std::size_t offset, BoardLayout layout,
+            int width, int height);
+
+private:
+  enum Plane { Mines, Revealed, Flagged, Suspected, Triggered, PlanesCount };
+
+  std::uint64_t *plane(Plane plane) {
+    return m_planes + plane * m_planeSize;
+  }
+  const std::uint64_t *plane(Plane plane) const {
+    return m_planes + plane * m_planeSize;
+  }
+  bool test(Plane plane, int index) const {
+    return (this->plane(plane)[index >> 6] >> (index & 63)) & 1;
+  }
+  static int lowestBit(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    auto bit{0};
+    for (; !(word & 1); word >>= 1) {
+      bit++;
+    }
+    return bit;
+#endif
+  }
+  void assign(Plane plane, int index, bool value) {
+    auto &word{this->plane(plane)[index >> 6]};
+    auto mask{std::uint64_t{1} << (index & 63)};
+    word = value ? word | mask : word & ~mask;
+  }
+
+  int m_width;
+  int m_height;
+  int m_planeSize;
+  std::vector<std::uint64_t> m_words;
+  std::vector<std::uint8_t> m_neighbourMinesCounts;
+  MappedFile m_file;
+  std::uint64_t *m_planes;
+  std::uint8_t *m_counts;
+};
+
+template <typename Record> void BitBoard::revealAllMines(Record record) {
+  Cell revealedCell;
+  revealedCell.setStatus(Cell::Status::Revealed);
+  Cell suspectedCell;
+  suspectedCell.setStatus(Cell::Status::MarkedAsSuspect);
+  auto hiddenMask{revealedCell.bits()};
+  auto suspectedMask{
+      static_cast<std::uint8_t>(revealedCell.bits() ^ suspectedCell.bits())};
+  auto mines{plane(Mines)};
+  auto revealed{plane(Revealed)};
+  auto flagged{plane(Flagged)};
+  auto suspected{plane(Suspected)};
+  for (auto i = 0; i < m_planeSize; i++) {
+    auto changed{mines[i] & ~flagged[i] & ~revealed[i]};
+    for (auto bits = changed; bits != 0; bits &= bits - 1) {
+      auto bit{lowestBit(bits)};
+      record(i * 64 + bit,
+             (suspected[i] >> bit) & 1 ? suspectedMask : hiddenMask);
+    }
+    revealed[i] |= changed;
+    suspected[i] &= ~changed;
+  }
+}
+
+#endif
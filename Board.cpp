@@ -0,0 +1,120 @@
+#include "Board.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+enum Plane { Mines, Revealed, Flagged, Suspected, Triggered, PlanesCount };
+} // namespace
+
+static_assert(sizeof(Cell) == sizeof(std::uint8_t));
+
+Board::Board()
+    : m_width{0}, m_height{0}, m_storage{}, m_file{}, m_cells{nullptr} {}
+
+void Board::reset(int width, int height) {
+  m_width = width;
+  m_height = height;
+  m_storage.assign(static_cast<std::size_t>(width) * height, Cell{});
+  m_file.close();
+  m_cells = m_storage.data();
+}
+
+int Board::minesCount() const {
+  auto count{0};
+  for (auto index = 0; index < size(); index++) {
+    if (m_cells[index].type() == Cell::Type::Mine) {
+      count++;
+    }
+  }
+  return count;
+}
+
+int Board::flagsCount() const {
+  auto count{0};
+  for (auto index = 0; index < size(); index++) {
+    if (m_cells[index].status() == Cell::Status::MarkedAsMine) {
+      count++;
+    }
+  }
+  return count;
+}
+
+int Board::revealedSafeCellsCount() const {
+  auto count{0};
+  for (auto index = 0; index < size(); index++) {
+    auto cell{m_cells[index]};
+    if (cell.status() == Cell::Status::Revealed &&
+        cell.type() != Cell::Type::Mine) {
+      count++;
+    }
+  }
+  return count;
+}
+
+bool Board::allSafeCellsRevealed() const {
+  for (auto index = 0; index < size(); index++) {
+    auto cell{m_cells[index]};
+    if (cell.type() != Cell::Type::Mine &&
+        cell.status() != Cell::Status::Revealed) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Board::store(std::ostream &stream) const {
+  stream.write(reinterpret_cast<const char *>(m_cells), size());
+}
+
+bool Board::load(MappedFile file, std::size_t offset, BoardLayout layout,
+                 int width, int height) {
+  if (file.size() < offset + boardStorageSize(layout, width, height)) {
+    return false;
+  }
+  if (layout == BoardLayout::Planes) {
+    reset(width, height);
+    loadPlanes(file.data() + offset);
+    return true;
+  }
+  m_width = width;
+  m_height = height;
+  m_storage = {};
+  m_file = std::move(file);
+  m_cells = reinterpret_cast<Cell *>(m_file.data() + offset);
+  return true;
+}
+
+void Board::loadPlanes(const std::uint8_t *data) {
+  auto cells{static_cast<std::size_t>(size())};
+  auto wordsCount{(cells + 63) / 64};
+  auto counts{data + wordsCount * PlanesCount * sizeof(std::uint64_t)};
+  for (std::size_t word = 0; word < wordsCount; word++) {
+    std::uint64_t bits[PlanesCount];
+    for (auto plane = 0; plane < PlanesCount; plane++) {
+      std::memcpy(&bits[plane],
+                  data + (plane * wordsCount + word) * sizeof(bits[0]),
+                  sizeof(bits[0]));
+    }
+    auto base{word * 64};
+    auto end{std::min(base + 64, cells)};
+    for (auto index = base; index < end; index++) {
+      auto shift{index - base};
+      Cell cell;
+      cell.setNeighbourMinesCount(counts[index]);
+      if ((bits[Mines] >> shift) & 1) {
+        cell.setType(Cell::Type::Mine);
+      }
+      if ((bits[Revealed] >> shift) & 1) {
+        cell.setStatus(Cell::Status::Revealed);
+      } else if ((bits[Flagged] >> shift) & 1) {
+        cell.setStatus(Cell::Status::MarkedAsMine);
+      } else if ((bits[Suspected] >> shift) & 1) {
+        cell.setStatus(Cell::Status::MarkedAsSuspect);
+      }
+      cell.setTriggered((bits[Triggered] >> shift) & 1);
+      m_cells[index] = cell;
+    }
+  }
+}
@@ -0,0 +1,75 @@
+#ifndef MINESWEEPER_BOARD_HPP
+#define MINESWEEPER_BOARD_HPP
+
+#include <ostream>
+#include <vector>
+
+#include "BoardLayout.hpp"
+#include "Cell.hpp"
+#include "MappedFile.hpp"
+
+// Stores one packed Cell byte per cell. A board loaded from its own layout
+// works directly on the cells of the mapped file.
+class Board {
+public:
+  static constexpr BoardLayout layout{BoardLayout::Cells};
+
+  Board();
+
+  Board(const Board &) = delete;
+  Board &operator=(const Board &) = delete;
+  Board(Board &&) = default;
+  Board &operator=(Board &&) = default;
+
+  int width() const { return m_width; }
+  int height() const { return m_height; }
+  int size() const { return m_width * m_height; }
+  bool empty() const { return size() == 0; }
+
+  int index(int col, int row) const { return row * m_width + col; }
+  int col(int index) const { return index % m_width; }
+  int row(int index) const { return index / m_width; }
+  bool contains(int col, int row) const {
+    return col >= 0 && col < m_width && row >= 0 && row < m_height;
+  }
+
+  Cell cell(int index) const { return m_cells[index]; }
+  Cell cell(int col, int row) const { return m_cells[index(col, row)]; }
+  void setCell(int index, Cell cell) { m_cells[index] = cell; }
+
+  void reset(int width, int height);
+  template <typename Record> void revealAllMines(Record record);
+  int minesCount() const;
+  int flagsCount() const;
+  int revealedSafeCellsCount() const;
+  bool allSafeCellsRevealed() const;
+
+  void store(std::ostream &stream) const;
+  bool load(MappedFile file, std::size_t offset, BoardLayout layout,
+            int width, int height);
+
+private:
+  void loadPlanes(const std::uint8_t *data);
+
+  int m_width;
+  int m_height;
+  std::vector<Cell> m_storage;
+  MappedFile m_file;
+  Cell *m_cells;
+};
+
+template <typename Record> void Board::revealAllMines(Record record) {
+  for (auto index = 0; index < size(); index++) {
+    auto cell{m_cells[index]};
+    if (cell.type() == Cell::Type::Mine &&
+        cell.status() != Cell::Status::MarkedAsMine &&
+        cell.status() != Cell::Status::Revealed) {
+      auto bits{cell.bits()};
+      cell.setStatus(Cell::Status::Revealed);
+      record(index, static_cast<std::uint8_t>(bits ^ cell.bits()));
+      m_cells[index] = cell;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef MINESWEEPER_BOARD_LAYOUT_HPP
+#define MINESWEEPER_BOARD_LAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// On-disk layouts of a board. Planes is the BitBoard layout: the mine,
+// revealed, flagged, suspected and triggered planes as 64-bit words, then one
+// neighbour mines count byte per cell. Cells is the Board layout: one packed
+// Cell byte per cell. Each board maps its own layout and converts the other.
+enum class BoardLayout : std::int32_t { Planes, Cells };
+
+inline std::size_t boardStorageSize(BoardLayout layout, int width,
+                                    int height) {
+  constexpr std::size_t planesCount{5};
+  auto cells{static_cast<std::size_t>(width) * height};
+  if (layout == BoardLayout::Cells) {
+    return cells;
+  }
+  return (cells + 63) / 64 * planesCount * sizeof(std::uint64_t) + cells;
+}
+
+#endif
@@ -1,16 +1,63 @@
 #ifndef MINESWEEPER_CELL_HPP
 #define MINESWEEPER_CELL_HPP
 
-struct Cell {
+#include <cstdint>
+
+class Cell {
+public:
   enum class Type { Empty, Mine };
   enum class Status { Hidden, Revealed, MarkedAsMine, MarkedAsSuspect };
 
-  int col{0};
-  int row{0};
-  int neighbourMinesCount{0};
-  Type type{Type::Empty};
-  Status status{Status::Hidden};
-  bool triggered{false};
+  constexpr Cell() : m_bits{0} {}
+  constexpr explicit Cell(std::uint8_t bits) : m_bits{bits} {}
+
+  constexpr std::uint8_t bits() const { return m_bits; }
+
+  constexpr int neighbourMinesCount() const { return m_bits & f_countMask; }
+
+  constexpr Type type() const {
+    return (m_bits & f_mineMask) ? Type::Mine : Type::Empty;
+  }
+
+  constexpr Status status() const {
+    return static_cast<Status>((m_bits & f_statusMask) >> f_statusShift);
+  }
+
+  constexpr bool triggered() const { return m_bits & f_triggeredMask; }
+
+  void setNeighbourMinesCount(int count) {
+    m_bits = static_cast<std::uint8_t>((m_bits & ~f_countMask) |
+                                       (count & f_countMask));
+  }
+
+  void setType(Type type) {
+    m_bits = static_cast<std::uint8_t>(
+        type == Type::Mine ? m_bits | f_mineMask : m_bits & ~f_mineMask);
+  }
+
+  void setStatus(Status status) {
+    m_bits = static_cast<std::uint8_t>(
+        (m_bits & ~f_statusMask) |
+        (static_cast<int>(status) << f_statusShift));
+  }
+
+  void setTriggered(bool triggered) {
+    m_bits = static_cast<std::uint8_t>(triggered ? m_bits | f_triggeredMask
+                                                 : m_bits & ~f_triggeredMask);
+  }
+
+private:
+  // Bits 0-3: neighbour mines count, bit 4: mine, bits 5-6: status,
+  // bit 7: triggered.
+  static constexpr int f_countMask{0x0F};
+  static constexpr int f_mineMask{0x10};
+  static constexpr int f_statusShift{5};
+  static constexpr int f_statusMask{0x60};
+  static constexpr int f_triggeredMask{0x80};
+
+  std::uint8_t m_bits;
 };
 
+static_assert(sizeof(Cell) == 1);
+
 #endif
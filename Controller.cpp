@@ -1,10 +1,24 @@
 #include "Controller.hpp"
 #include "Model.hpp"
 
+#include <cstdio>
+
 Controller::Controller(View &view, Model &model)
-    : m_view{view}, m_model{model} {}
+    : m_view{view}, m_model{model}, m_dragPosition{}, m_tracer{nullptr},
+      m_savePath{} {
+  m_model.subscribe(this);
+}
+
+Controller::~Controller() { m_model.unsubscribe(this); }
+
+void Controller::setTracer(LatencyTracer *tracer) { m_tracer = tracer; }
+
+void Controller::setSavePath(const std::string &path) { m_savePath = path; }
 
 void Controller::onEvent(const sf::Event &event) {
+  if (m_tracer) {
+    m_tracer->onInput();
+  }
   switch (event.type) {
   case sf::Event::Closed:
     m_view.closeWindow();
@@ -12,17 +26,33 @@ void Controller::onEvent(const sf::Event &event) {
   case sf::Event::MouseButtonPressed:
     onMouseButtonPressed(event.mouseButton);
     return;
+  case sf::Event::MouseButtonReleased:
+    onMouseButtonReleased(event.mouseButton);
+    return;
+  case sf::Event::MouseMoved:
+    onMouseMoved(event.mouseMove);
+    return;
   case sf::Event::MouseWheelScrolled:
     onMouseWheelScrolled(event.mouseWheelScroll);
     return;
   case sf::Event::KeyPressed:
     onKeyPressed(event.key);
     return;
+  case sf::Event::Resized:
+  case sf::Event::GainedFocus:
+    m_view.invalidate();
+    return;
   default:
     return;
   }
 }
 
+void Controller::onChanges(const Model::Changes &changes) {
+  if (m_tracer && changes.change == Model::Change::Restart) {
+    m_tracer->onCompletion(LatencyTracer::Action::Restart);
+  }
+}
+
 void Controller::onMouseWheelScrolled(
     const sf::Event::MouseWheelScrollEvent &event) {
   if (event.delta > 0) {
@@ -32,15 +62,16 @@ void Controller::onMouseWheelScrolled(
   }
 }
 
-void Controller ::onMouseLeftButtonPressedOnBarMenu() {
-  auto highlightedButton{m_view.buttonUnderMouse()};
-  switch (highlightedButton) {
+void Controller ::onMouseLeftButtonPressedOnBarMenu(View::Button button) {
+  switch (button) {
   case View::Button::Quit:
     m_view.closeWindow();
     return;
   case View::Button::Restart:
-    m_model.restart();
-    return;
+    if (m_tracer) {
+      m_tracer->onRequest(LatencyTracer::Action::Restart);
+    }
+    return m_model.restart();
   case View::Button::Size:
     if (m_model.status() == Model::Status::Ready) {
       m_model.cycleSize();
@@ -51,62 +82,118 @@ void Controller ::onMouseLeftButtonPressedOnBarMenu() {
   }
 }
 
-void Controller ::onMouseLeftButtonPressedOnCell() {
-  auto pos{m_view.cellUnderMouse()};
+void Controller ::onMouseLeftButtonPressedOnCell(int col, int row) {
   if (m_model.status() == Model::Status::Finished) {
     return;
   }
-  m_model.reveal(pos->first, pos->second);
+  m_model.reveal(col, row);
+  trace(LatencyTracer::Action::Reveal);
   return;
 }
 
-void Controller::onMouseRightButtonPressedOnCell() {
+void Controller::onMouseRightButtonPressedOnCell(int col, int row) {
   if (m_model.status() == Model::Status::Finished) {
     return;
   }
-  auto pos{m_view.cellUnderMouse()};
-  m_model.cycleCellStatus(pos->first, pos->second);
+  m_model.cycleCellStatus(col, row);
+  trace(LatencyTracer::Action::Flag);
 }
 
-void Controller::onMouseBothButtonsPressedOnCell() {
+void Controller::onMouseBothButtonsPressedOnCell(int col, int row) {
   if (m_model.status() == Model::Status::Finished) {
     return;
   }
-  auto pos{m_view.cellUnderMouse()};
-  m_model.tryRevealNeighbours(pos->first, pos->second);
+  m_model.tryRevealNeighbours(col, row);
+  trace(LatencyTracer::Action::Chord);
 }
 
 void Controller::onMouseButtonPressed(
     const sf::Event::MouseButtonEvent &event) {
-  auto cellIsHighlighted{m_view.cellUnderMouse().has_value()};
+  sf::Vector2i pixel{event.x, event.y};
+  auto cell{m_view.cellAtPixel(pixel)};
   auto bothButtonsPressed{sf::Mouse::isButtonPressed(sf::Mouse::Left) &&
                           sf::Mouse::isButtonPressed(sf::Mouse::Right)};
-  if (cellIsHighlighted && bothButtonsPressed) {
-    return onMouseBothButtonsPressedOnCell();
+  if (cell && bothButtonsPressed) {
+    return onMouseBothButtonsPressedOnCell(cell->first, cell->second);
   }
-  auto buttonIsHighlighted{m_view.buttonUnderMouse() != View::Button::None};
+  auto button{m_view.buttonAtPixel(pixel)};
   switch (event.button) {
+  case sf::Mouse::Button::Middle:
+    m_dragPosition = pixel;
+    return;
   case sf::Mouse::Button::Left:
-    if (buttonIsHighlighted) {
-      return onMouseLeftButtonPressedOnBarMenu();
-    } else if (cellIsHighlighted) {
-      return onMouseLeftButtonPressedOnCell();
+    if (button != View::Button::None) {
+      return onMouseLeftButtonPressedOnBarMenu(button);
+    } else if (cell) {
+      return onMouseLeftButtonPressedOnCell(cell->first, cell->second);
     }
     return;
   case sf::Mouse::Button::Right:
-    if (cellIsHighlighted) {
-      return onMouseRightButtonPressedOnCell();
+    if (cell) {
+      return onMouseRightButtonPressedOnCell(cell->first, cell->second);
     }
   default:
     return;
   }
 }
 
+void Controller::onMouseButtonReleased(
+    const sf::Event::MouseButtonEvent &event) {
+  if (event.button == sf::Mouse::Button::Middle) {
+    m_dragPosition.reset();
+  }
+}
+
+void Controller::onMouseMoved(const sf::Event::MouseMoveEvent &event) {
+  if (!m_dragPosition) {
+    return;
+  }
+  sf::Vector2i pixel{event.x, event.y};
+  m_view.drag(*m_dragPosition, pixel);
+  m_dragPosition = pixel;
+}
+
+void Controller::trace(LatencyTracer::Action action) {
+  if (m_tracer) {
+    m_tracer->onAction(action);
+  }
+}
+
 void Controller::onKeyPressed(const sf::Event::KeyEvent &event) {
   switch (event.code) {
   case sf::Keyboard::Escape:
     m_view.closeWindow();
     return;
+  case sf::Keyboard::F3:
+    return m_view.toggleProfiler();
+  case sf::Keyboard::Left:
+    return m_view.pan(View::Direction::Left);
+  case sf::Keyboard::Right:
+    return m_view.pan(View::Direction::Right);
+  case sf::Keyboard::Up:
+    return m_view.pan(View::Direction::Up);
+  case sf::Keyboard::Down:
+    return m_view.pan(View::Direction::Down);
+  case sf::Keyboard::Z:
+    if (event.control) {
+      m_model.undo();
+    }
+    return;
+  case sf::Keyboard::Y:
+    if (event.control) {
+      m_model.redo();
+    }
+    return;
+  case sf::Keyboard::S:
+    if (event.control && !m_model.save(m_savePath)) {
+      std::fprintf(stderr, "cannot save %s\n", m_savePath.c_str());
+    }
+    return;
+  case sf::Keyboard::L:
+    if (event.control && !m_model.load(m_savePath)) {
+      std::fprintf(stderr, "cannot load %s\n", m_savePath.c_str());
+    }
+    return;
   default:
     return;
   }
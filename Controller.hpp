@@ -2,27 +2,43 @@
 #define MINESWEEPER_CONTROLLER_HPP
 
 #include <SFML/Window/Event.hpp>
+#include <optional>
+#include <string>
 
+#include "LatencyTracer.hpp"
 #include "Model.hpp"
 #include "View.hpp"
 
-class Controller {
+class Controller : public Model::Listener {
 public:
   Controller(View &view, Model &model);
+  Controller(const Controller &) = delete;
+  Controller &operator=(const Controller &) = delete;
+  ~Controller() override;
+
+  void setTracer(LatencyTracer *tracer);
+  void setSavePath(const std::string &path);
 
   void onEvent(const sf::Event &event);
+  void onChanges(const Model::Changes &changes) override;
 
 private:
-  void onMouseLeftButtonPressedOnBarMenu();
-  void onMouseLeftButtonPressedOnCell();
-  void onMouseRightButtonPressedOnCell();
-  void onMouseBothButtonsPressedOnCell();
+  void onMouseLeftButtonPressedOnBarMenu(View::Button button);
+  void onMouseLeftButtonPressedOnCell(int col, int row);
+  void onMouseRightButtonPressedOnCell(int col, int row);
+  void onMouseBothButtonsPressedOnCell(int col, int row);
   void onMouseButtonPressed(const sf::Event::MouseButtonEvent &event);
+  void onMouseButtonReleased(const sf::Event::MouseButtonEvent &event);
+  void onMouseMoved(const sf::Event::MouseMoveEvent &event);
   void onMouseWheelScrolled(const sf::Event::MouseWheelScrollEvent &event);
   void onKeyPressed(const sf::Event::KeyEvent &event);
+  void trace(LatencyTracer::Action action);
 
   View &m_view;
   Model &m_model;
+  std::optional<sf::Vector2i> m_dragPosition;
+  LatencyTracer *m_tracer;
+  std::string m_savePath;
 };
 
 #endif
@@ -0,0 +1,97 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+
+namespace {
+constexpr std::size_t f_windowFrames{240};
+constexpr auto f_p99{.99};
+} // namespace
+
+FrameProfiler::Scope::Scope(FrameProfiler *profiler, Stage stage)
+    : m_profiler{profiler}, m_stage{stage},
+      m_start{profiler ? std::chrono::steady_clock::now()
+                       : std::chrono::steady_clock::time_point{}} {}
+
+FrameProfiler::Scope::~Scope() {
+  if (m_profiler) {
+    m_profiler->record(m_stage, std::chrono::steady_clock::now() - m_start);
+  }
+}
+
+FrameProfiler::FrameProfiler()
+    : m_samples(f_windowFrames * stagesCount), m_current{}, m_frames{0},
+      m_sorted(f_windowFrames), m_csv{} {}
+
+const char *FrameProfiler::stageName(Stage stage) {
+  switch (stage) {
+  case Stage::Events:
+    return "events";
+  case Stage::Model:
+    return "model_update";
+  case Stage::Background:
+    return "background";
+  case Stage::Cells:
+    return "cells";
+  case Stage::Menu:
+    return "menu";
+  case Stage::ScaleWindow:
+    return "scale_window";
+  default:
+  case Stage::Display:
+    return "display";
+  }
+}
+
+std::size_t FrameProfiler::frames() const { return m_frames; }
+
+FrameProfiler::Statistics FrameProfiler::statistics(Stage stage) const {
+  auto count{std::min(m_frames, f_windowFrames)};
+  if (count == 0) {
+    return {};
+  }
+  auto offset{static_cast<std::size_t>(stage)};
+  auto sum{0.};
+  for (std::size_t i = 0; i < count; i++) {
+    m_sorted[i] = m_samples[i * stagesCount + offset];
+    sum += m_sorted[i];
+  }
+  auto end{m_sorted.begin() + static_cast<std::ptrdiff_t>(count)};
+  auto p99{m_sorted.begin() +
+           static_cast<std::ptrdiff_t>(static_cast<double>(count - 1) * f_p99)};
+  std::nth_element(m_sorted.begin(), p99, end);
+  return {*std::min_element(m_sorted.begin(), end), sum / count, *p99};
+}
+
+bool FrameProfiler::openCsv(const std::string &path) {
+  m_csv.open(path);
+  if (!m_csv) {
+    return false;
+  }
+  m_csv << "frame";
+  for (std::size_t i = 0; i < stagesCount; i++) {
+    m_csv << "," << stageName(static_cast<Stage>(i)) << "_ms";
+  }
+  m_csv << "\n";
+  return true;
+}
+
+void FrameProfiler::record(Stage stage,
+                           std::chrono::steady_clock::duration duration) {
+  m_current[static_cast<std::size_t>(stage)] +=
+      std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void FrameProfiler::endFrame() {
+  if (m_csv.is_open()) {
+    m_csv << m_frames;
+    for (auto sample : m_current) {
+      m_csv << "," << sample;
+    }
+    m_csv << "\n";
+  }
+  std::copy(m_current.begin(), m_current.end(),
+            m_samples.begin() + static_cast<std::ptrdiff_t>(
+                                    (m_frames % f_windowFrames) * stagesCount));
+  m_current.fill(0.);
+  m_frames++;
+}
@@ -0,0 +1,65 @@
+#ifndef MINESWEEPER_FRAME_PROFILER_HPP
+#define MINESWEEPER_FRAME_PROFILER_HPP
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Per-stage frame timings kept over a rolling window of frames, optionally
+// streamed to a CSV file with one row per frame.
+class FrameProfiler {
+public:
+  enum class Stage {
+    Events,
+    Model,
+    Background,
+    Cells,
+    Menu,
+    ScaleWindow,
+    Display
+  };
+
+  static constexpr std::size_t stagesCount{7};
+
+  struct Statistics {
+    double minMs{0.};
+    double avgMs{0.};
+    double p99Ms{0.};
+  };
+
+  class Scope {
+  public:
+    Scope(FrameProfiler *profiler, Stage stage);
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+  private:
+    FrameProfiler *m_profiler;
+    Stage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  FrameProfiler();
+
+  static const char *stageName(Stage stage);
+
+  std::size_t frames() const;
+  Statistics statistics(Stage stage) const;
+
+  bool openCsv(const std::string &path);
+  void record(Stage stage, std::chrono::steady_clock::duration duration);
+  void endFrame();
+
+private:
+  std::vector<double> m_samples;
+  std::array<double, stagesCount> m_current;
+  std::size_t m_frames;
+  mutable std::vector<double> m_sorted;
+  std::ofstream m_csv;
+};
+
+#endif
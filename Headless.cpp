@@ -0,0 +1,68 @@
+#include <cstdio>
+#include <fstream>
+
+#include "Model.hpp"
+#include "Options.hpp"
+#include "Replay.hpp"
+#include "Simulator.hpp"
+
+namespace {
+inline bool endsWith(const std::string &text, const std::string &suffix) {
+  return text.size() >= suffix.size() &&
+         text.compare(text.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+int replay(const Options &options) {
+  Model model;
+  ReplayPlayer player{model};
+  if (!player.open(options.replay)) {
+    std::fprintf(stderr, "cannot open replay %s\n", options.replay.c_str());
+    return 1;
+  }
+  auto summary{player.play(options.realTimeReplay)};
+  std::printf("boards %lld, actions %lld, wins %lld, losses %lld\n",
+              summary.restarts, summary.actions, summary.wins,
+              summary.losses);
+  std::printf("model %.3f ms, wall %.3f s%s\n", summary.modelSeconds * 1e3,
+              summary.wallSeconds, summary.truncated ? ", truncated" : "");
+  return summary.truncated ? 1 : 0;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  auto options{parseOptions(argc, argv)};
+  if (!options.replay.empty()) {
+    return replay(options);
+  }
+  Simulator simulator{options};
+  auto stats{simulator.run()};
+  auto games{static_cast<double>(stats.games > 0 ? stats.games : 1)};
+  std::printf("games %lld, wins %lld, clicks/game %.1f, revealed/game %.1f\n",
+              stats.games, stats.wins, stats.clicks / games,
+              stats.revealedCells / games);
+  std::printf("threads %d, time %.3f s, %.0f games/s, %.3f ms/game\n",
+              simulator.threads(), simulator.wallSeconds(),
+              stats.games / simulator.wallSeconds(),
+              stats.seconds * 1e3 / games);
+  if (options.noGuess) {
+    std::printf("no-guess generation p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, "
+                "max %.2f ms\n",
+                stats.generationP50Ms, stats.generationP90Ms,
+                stats.generationP99Ms, stats.generationMaxMs);
+  }
+  if (options.output.empty()) {
+    return 0;
+  }
+  std::ofstream file{options.output};
+  if (!file) {
+    std::fprintf(stderr, "cannot open %s\n", options.output.c_str());
+    return 1;
+  }
+  if (endsWith(options.output, ".json")) {
+    stats.writeJson(file, simulator.threads(), simulator.wallSeconds());
+  } else {
+    stats.writeCsv(file, simulator.threads(), simulator.wallSeconds());
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "Journal.hpp"
+
+namespace {
+inline bool sameState(const Journal::State &a, const Journal::State &b) {
+  return a.status == b.status &&
+         a.revealedCellsCount == b.revealedCellsCount &&
+         a.markedMinesCount == b.markedMinesCount && a.success == b.success;
+}
+} // namespace
+
+Journal::Journal()
+    : m_indices{}, m_masks{}, m_actions(f_actionsCapacity), m_open{},
+      m_deltasEnd{0}, m_first{0}, m_cursor{0}, m_last{0},
+      m_recording{false} {}
+
+bool Journal::recording() const { return m_recording; }
+
+bool Journal::canUndo() const { return !m_recording && m_cursor > m_first; }
+
+bool Journal::canRedo() const { return !m_recording && m_cursor < m_last; }
+
+void Journal::clear() {
+  m_deltasEnd = 0;
+  m_first = 0;
+  m_cursor = 0;
+  m_last = 0;
+  m_recording = false;
+}
+
+void Journal::begin(const State &state) {
+  auto start{m_cursor < m_last ? action(m_cursor).begin : m_deltasEnd};
+  m_open = {start, start, state, state};
+  m_recording = true;
+}
+
+bool Journal::reopen() {
+  if (m_recording || m_cursor == m_first || m_cursor < m_last) {
+    return false;
+  }
+  m_open = action(--m_cursor);
+  m_recording = true;
+  return true;
+}
+
+void Journal::record(int index, std::uint8_t mask) {
+  if (!m_recording || mask == 0) {
+    return;
+  }
+  auto slot{static_cast<std::size_t>(m_open.end % f_deltasCapacity)};
+  if (slot == m_indices.size()) {
+    m_indices.push_back(index);
+    m_masks.push_back(mask);
+  } else {
+    m_indices[slot] = index;
+    m_masks[slot] = mask;
+  }
+  m_open.end++;
+}
+
+void Journal::commit(const State &state) {
+  if (!m_recording) {
+    return;
+  }
+  m_recording = false;
+  if (m_open.end - m_open.begin > f_deltasCapacity) {
+    return clear();
+  }
+  if (m_open.begin == m_open.end && sameState(m_open.before, state)) {
+    return;
+  }
+  if (m_cursor - m_first == f_actionsCapacity) {
+    m_first++;
+  }
+  m_open.after = state;
+  action(m_cursor) = m_open;
+  m_deltasEnd = m_open.end;
+  m_last = ++m_cursor;
+  while (m_first < m_cursor &&
+         action(m_first).begin + f_deltasCapacity < m_deltasEnd) {
+    m_first++;
+  }
+}
+
+Journal::Action &Journal::action(std::uint64_t id) {
+  return m_actions[static_cast<std::size_t>(id % f_actionsCapacity)];
+}
@@ -0,0 +1,85 @@
+#ifndef MINESWEEPER_JOURNAL_HPP
+#define MINESWEEPER_JOURNAL_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Undo history of player actions. Each action keeps the counters before and
+// after it and the cells it changed, as an index and the XOR of the old and
+// new cell bits, in a ring buffer of bounded size. Actions whose cells have
+// been overwritten are forgotten.
+class Journal {
+public:
+  struct State {
+    int status{0};
+    int revealedCellsCount{0};
+    int markedMinesCount{0};
+    bool success{false};
+  };
+
+  Journal();
+
+  bool recording() const;
+  bool canUndo() const;
+  bool canRedo() const;
+
+  void clear();
+  void begin(const State &state);
+  bool reopen();
+  void record(int index, std::uint8_t mask);
+  void commit(const State &state);
+
+  template <typename Apply> bool undo(Apply apply, State &state);
+  template <typename Apply> bool redo(Apply apply, State &state);
+
+private:
+  static constexpr std::uint64_t f_deltasCapacity{1 << 20};
+  static constexpr std::uint64_t f_actionsCapacity{1024};
+
+  struct Action {
+    std::uint64_t begin;
+    std::uint64_t end;
+    State before;
+    State after;
+  };
+
+  Action &action(std::uint64_t id);
+
+  std::vector<std::int32_t> m_indices;
+  std::vector<std::uint8_t> m_masks;
+  std::vector<Action> m_actions;
+  Action m_open;
+  std::uint64_t m_deltasEnd;
+  std::uint64_t m_first;
+  std::uint64_t m_cursor;
+  std::uint64_t m_last;
+  bool m_recording;
+};
+
+template <typename Apply> bool Journal::undo(Apply apply, State &state) {
+  if (!canUndo()) {
+    return false;
+  }
+  auto &undone{action(--m_cursor)};
+  for (auto position = undone.end; position > undone.begin; position--) {
+    auto slot{(position - 1) % f_deltasCapacity};
+    apply(m_indices[slot], m_masks[slot]);
+  }
+  state = undone.before;
+  return true;
+}
+
+template <typename Apply> bool Journal::redo(Apply apply, State &state) {
+  if (!canRedo()) {
+    return false;
+  }
+  auto &redone{action(m_cursor++)};
+  for (auto position = redone.begin; position < redone.end; position++) {
+    auto slot{position % f_deltasCapacity};
+    apply(m_indices[slot], m_masks[slot]);
+  }
+  state = redone.after;
+  return true;
+}
+
+#endif
@@ -0,0 +1,130 @@
+#include "LatencyTracer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+constexpr auto f_histogramBuckets{32};
+
+inline double percentile(std::vector<double> samples, double fraction) {
+  if (samples.empty()) {
+    return 0.;
+  }
+  auto index{static_cast<std::size_t>(
+      fraction * static_cast<double>(samples.size() - 1))};
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+inline double milliseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+inline int histogramBucket(double ms) {
+  auto us{std::max(ms * 1e3, 1.)};
+  return std::min(static_cast<int>(std::ceil(std::log2(us))),
+                  f_histogramBuckets - 1);
+}
+} // namespace
+
+LatencyTracer::LatencyTracer()
+    : m_input{}, m_requests{}, m_pending{}, m_latencies{},
+      m_modelLatencies{} {}
+
+const char *LatencyTracer::actionName(Action action) {
+  switch (action) {
+  case Action::Reveal:
+    return "reveal";
+  case Action::Flag:
+    return "flag";
+  case Action::Chord:
+    return "chord";
+  default:
+  case Action::Restart:
+    return "restart";
+  }
+}
+
+LatencyTracer::Summary LatencyTracer::summary(Action action) const {
+  const auto &latencies{m_latencies[static_cast<std::size_t>(action)]};
+  const auto &modelLatencies{
+      m_modelLatencies[static_cast<std::size_t>(action)]};
+  if (latencies.empty()) {
+    return {};
+  }
+  return {latencies.size(),
+          percentile(latencies, .5),
+          percentile(latencies, .9),
+          percentile(latencies, .99),
+          *std::max_element(latencies.begin(), latencies.end()),
+          std::accumulate(modelLatencies.begin(), modelLatencies.end(), 0.) /
+              static_cast<double>(modelLatencies.size())};
+}
+
+void LatencyTracer::writeSummary(std::ostream &stream) const {
+  for (std::size_t i = 0; i < actionsCount; i++) {
+    auto action{static_cast<Action>(i)};
+    auto result{summary(action)};
+    if (result.count == 0) {
+      continue;
+    }
+    stream << actionName(action) << ": " << result.count
+           << " actions, input to display p50 " << result.p50Ms
+           << " ms, p90 " << result.p90Ms << " ms, p99 " << result.p99Ms
+           << " ms, max " << result.maxMs << " ms, input to model "
+           << result.meanModelMs << " ms mean\n";
+  }
+}
+
+void LatencyTracer::writeHistogramCsv(std::ostream &stream) const {
+  stream << "action,upper_us,count\n";
+  for (std::size_t i = 0; i < actionsCount; i++) {
+    std::array<int, f_histogramBuckets> buckets{};
+    for (auto latency : m_latencies[i]) {
+      buckets[static_cast<std::size_t>(histogramBucket(latency))]++;
+    }
+    for (auto bucket = 0; bucket < f_histogramBuckets; bucket++) {
+      if (buckets[static_cast<std::size_t>(bucket)] > 0) {
+        stream << actionName(static_cast<Action>(i)) << ","
+               << (1LL << bucket) << ","
+               << buckets[static_cast<std::size_t>(bucket)] << "\n";
+      }
+    }
+  }
+}
+
+void LatencyTracer::onInput() { m_input = Clock::now(); }
+
+void LatencyTracer::onAction(Action action) {
+  m_pending.push_back({action, m_input, Clock::now()});
+}
+
+void LatencyTracer::onRequest(Action action) {
+  m_requests.push_back({action, m_input, {}});
+}
+
+void LatencyTracer::onCompletion(Action action) {
+  auto now{Clock::now()};
+  auto completed{std::stable_partition(
+      m_requests.begin(), m_requests.end(),
+      [action](const Pending &request) { return request.action != action; })};
+  for (auto request = completed; request != m_requests.end(); ++request) {
+    m_pending.push_back({action, request->input, now});
+  }
+  m_requests.erase(completed, m_requests.end());
+}
+
+void LatencyTracer::onDisplay() {
+  if (m_pending.empty()) {
+    return;
+  }
+  auto now{Clock::now()};
+  for (const auto &pending : m_pending) {
+    auto index{static_cast<std::size_t>(pending.action)};
+    m_latencies[index].push_back(milliseconds(now - pending.input));
+    m_modelLatencies[index].push_back(
+        milliseconds(pending.mutation - pending.input));
+  }
+  m_pending.clear();
+}
@@ -0,0 +1,58 @@
+#ifndef MINESWEEPER_LATENCY_TRACER_HPP
+#define MINESWEEPER_LATENCY_TRACER_HPP
+
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+// Input-to-display latency of player actions. Inputs are stamped when their
+// event is handled, actions when the model has changed, and both are closed
+// by the next displayed frame. An action the model completes later, such as a
+// restart waiting for its board, is requested first and stamped on completion.
+class LatencyTracer {
+public:
+  enum class Action { Reveal, Flag, Chord, Restart };
+
+  static constexpr std::size_t actionsCount{4};
+
+  struct Summary {
+    std::size_t count{0};
+    double p50Ms{0.};
+    double p90Ms{0.};
+    double p99Ms{0.};
+    double maxMs{0.};
+    double meanModelMs{0.};
+  };
+
+  LatencyTracer();
+
+  static const char *actionName(Action action);
+
+  Summary summary(Action action) const;
+  void writeSummary(std::ostream &stream) const;
+  void writeHistogramCsv(std::ostream &stream) const;
+
+  void onInput();
+  void onAction(Action action);
+  void onRequest(Action action);
+  void onCompletion(Action action);
+  void onDisplay();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Pending {
+    Action action;
+    Clock::time_point input;
+    Clock::time_point mutation;
+  };
+
+  Clock::time_point m_input;
+  std::vector<Pending> m_requests;
+  std::vector<Pending> m_pending;
+  std::array<std::vector<double>, actionsCount> m_latencies;
+  std::array<std::vector<double>, actionsCount> m_modelLatencies;
+};
+
+#endif
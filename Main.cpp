@@ -1,28 +1,96 @@
+#include <SFML/System/Clock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
 #include "Controller.hpp"
 #include "Model.hpp"
+#include "Options.hpp"
+#include "Replay.hpp"
 #include "View.hpp"
 
 namespace {
 constexpr auto f_windowTitle{"Minesweeper"};
 constexpr auto f_windowStyle{sf::Style::Fullscreen};
 constexpr auto f_antialiasing{4};
+constexpr auto f_idleMilliseconds{10};
 } // namespace
 
-int main() {
+int main(int argc, char *argv[]) {
+  auto options{parseOptions(argc, argv)};
   sf::RenderWindow window{sf::VideoMode::getDesktopMode(), f_windowTitle,
                           f_windowStyle,
                           sf::ContextSettings{0, 0, f_antialiasing}};
   window.setVerticalSyncEnabled(true);
   Model model;
+  applyOptions(options, model);
+  model.setPregeneration(true);
   View view{window, model};
   Controller controller{view, model};
+  FrameProfiler profiler;
+  if (!options.profile.empty() && !profiler.openCsv(options.profile)) {
+    std::fprintf(stderr, "cannot open %s\n", options.profile.c_str());
+  }
+  view.setProfiler(&profiler, !options.profile.empty());
+  LatencyTracer tracer;
+  if (!options.latency.empty()) {
+    controller.setTracer(&tracer);
+  }
+  controller.setSavePath(options.save);
+  ReplayRecorder recorder{model};
+  if (!options.record.empty() && !recorder.open(options.record)) {
+    std::fprintf(stderr, "cannot open %s\n", options.record.c_str());
+  }
+  sf::Clock clock;
+  auto cpuStart{std::clock()};
+  auto frames{0LL};
   while (window.isOpen()) {
     sf::Event event;
-    while (window.pollEvent(event)) {
+    {
+      FrameProfiler::Scope scope{view.activeProfiler(),
+                                 FrameProfiler::Stage::Events};
+      while (window.pollEvent(event)) {
+        controller.onEvent(event);
+      }
+    }
+    {
+      FrameProfiler::Scope scope{view.activeProfiler(),
+                                 FrameProfiler::Stage::Model};
+      model.update();
+    }
+    if (options.continuousRendering || view.needsUpdate()) {
+      view.update();
+      tracer.onDisplay();
+      if (auto active{view.activeProfiler()}) {
+        active->endFrame();
+      }
+      frames++;
+    } else if (model.status() == Model::Status::Running ||
+               model.restartPending()) {
+      sf::sleep(sf::milliseconds(f_idleMilliseconds));
+    } else if (window.waitEvent(event)) {
+      FrameProfiler::Scope scope{view.activeProfiler(),
+                                 FrameProfiler::Stage::Events};
       controller.onEvent(event);
     }
-    model.update();
-    view.update();
+  }
+  if (!options.profile.empty()) {
+    auto seconds{static_cast<double>(clock.getElapsedTime().asSeconds())};
+    auto cpuSeconds{static_cast<double>(std::clock() - cpuStart) /
+                    CLOCKS_PER_SEC};
+    std::fprintf(stderr, "frames %lld, %.1f fps, cpu %.1f%%\n", frames,
+                 frames / seconds, 100. * cpuSeconds / seconds);
+  }
+  if (!options.latency.empty()) {
+    tracer.writeSummary(std::cerr);
+    std::ofstream file{options.latency};
+    if (!file) {
+      std::fprintf(stderr, "cannot open %s\n", options.latency.c_str());
+      return 1;
+    }
+    tracer.writeHistogramCsv(file);
   }
   return 0;
 }
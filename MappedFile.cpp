@@ -0,0 +1,96 @@
+#include "MappedFile.hpp"
+
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MINESWEEPER_MMAP
+#else
+#include <fstream>
+#endif
+
+MappedFile::MappedFile() : m_data{nullptr}, m_size{0}, m_buffer{} {}
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_buffer{std::move(other.m_buffer)} {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    close();
+    m_data = std::exchange(other.m_data, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_buffer = std::move(other.m_buffer);
+  }
+  return *this;
+}
+
+bool MappedFile::open(const std::string &path) {
+  close();
+#ifdef MINESWEEPER_MMAP
+  auto descriptor{::open(path.c_str(), O_RDONLY)};
+  if (descriptor < 0) {
+    return false;
+  }
+  struct stat status;
+  if (::fstat(descriptor, &status) != 0 || status.st_size <= 0) {
+    ::close(descriptor);
+    return false;
+  }
+  auto size{static_cast<std::size_t>(status.st_size)};
+  auto data{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                   descriptor, 0)};
+  ::close(descriptor);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  m_data = static_cast<std::uint8_t *>(data);
+  m_size = size;
+  return true;
+#else
+  std::ifstream file{path, std::ios::binary | std::ios::ate};
+  if (!file) {
+    return false;
+  }
+  m_buffer.resize(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+  if (m_buffer.empty() ||
+      !file.read(reinterpret_cast<char *>(m_buffer.data()),
+                 static_cast<std::streamsize>(m_buffer.size()))) {
+    m_buffer.clear();
+    return false;
+  }
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  return true;
+#endif
+}
+
+bool MappedFile::read(std::istream &stream, std::size_t size) {
+  close();
+  m_buffer.resize(size);
+  if (size == 0 || !stream.read(reinterpret_cast<char *>(m_buffer.data()),
+                                static_cast<std::streamsize>(size))) {
+    m_buffer.clear();
+    return false;
+  }
+  m_data = m_buffer.data();
+  m_size = m_buffer.size();
+  return true;
+}
+
+void MappedFile::close() {
+#ifdef MINESWEEPER_MMAP
+  if (m_data && m_buffer.empty()) {
+    ::munmap(m_data, m_size);
+  }
+#endif
+  m_data = nullptr;
+  m_size = 0;
+  m_buffer.clear();
+}
@@ -0,0 +1,36 @@
+#ifndef MINESWEEPER_MAPPED_FILE_HPP
+#define MINESWEEPER_MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Private copy-on-write mapping of a whole file: pages are read on first
+// access and writes never reach the file. Falls back to reading the file into
+// memory where mmap is not available, and can hold bytes read from a stream.
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile();
+
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const std::string &path);
+  bool read(std::istream &stream, std::size_t size);
+  void close();
+
+  std::uint8_t *data() { return m_data; }
+  const std::uint8_t *data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+
+private:
+  std::uint8_t *m_data;
+  std::size_t m_size;
+  std::vector<std::uint8_t> m_buffer;
+};
+
+#endif
@@ -1,13 +1,46 @@
 #include "Model.hpp"
+#include "NeighbourCount.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <random>
+#include <utility>
 
 namespace {
-inline int generateRandomValue(int min, int max) {
+constexpr auto f_maxBoardSide{16384};
+constexpr auto f_changedCellsFraction{4};
+constexpr auto f_cancelCheckMask{0xFFFF};
+constexpr char f_saveMagic[]{'M', 'S', 'S', '1'};
+
+// Saved games are this header followed by the board in the layout of the
+// build that wrote it. Either build loads both layouts.
+struct SaveHeader {
+  char magic[4];
+  std::int32_t width;
+  std::int32_t height;
+  std::int32_t size;
+  std::int32_t minesCount;
+  std::int32_t markedMinesCount;
+  std::int32_t revealedCellsCount;
+  std::int32_t status;
+  std::int32_t success;
+  std::int32_t generation;
+  std::int32_t timeInSeconds;
+  std::int32_t layout;
+  std::uint64_t seed;
+  std::uint8_t padding[8];
+};
+
+static_assert(sizeof(SaveHeader) == 64);
+
+inline std::uint64_t generateSeed() {
   std::random_device rd;
-  std::mt19937 gen{rd()};
-  std::uniform_int_distribution<int> distr{min, max};
-  return distr(gen);
+  return (static_cast<std::uint64_t>(rd()) << 32) | rd();
+}
+
+inline int generateRandomIndex(std::mt19937_64 &rng, int size) {
+  return static_cast<int>(rng() % static_cast<std::uint64_t>(size));
 }
 
 inline int numberOfMines(Model::Size size) {
@@ -36,17 +69,29 @@ inline std::pair<int, int> sizeAsPair(Model::Size size) {
 } // namespace
 
 Model::Model()
-    : m_status{Status::Ready}, m_size{Size::Size30x16}, m_timeInSeconds{0},
-      m_minesCount{0}, m_markedMinesCount{0}, m_revealedCellsCount{0},
-      m_cellsToBeRevealed{0}, m_success{false}, m_cells{}, m_startTime{} {}
+    : m_status{Status::Ready}, m_revision{0}, m_size{Size::Size30x16},
+      m_width{sizeAsPair(m_size).first}, m_height{sizeAsPair(m_size).second},
+      m_customWidth{0}, m_customHeight{0}, m_customMinesCount{0},
+      m_timeInSeconds{0}, m_minesCount{numberOfMines(m_size)},
+      m_markedMinesCount{0}, m_revealedCellsCount{0},
+      m_cellsToBeRevealed{0}, m_success{false}, m_noGuessFallback{false},
+      m_generation{Generation::Random}, m_generator{}, m_seed{0}, m_rng{},
+      m_board{}, m_revealedCells{}, m_startTime{}, m_journal{},
+      m_pregeneration{false}, m_next{}, m_listeners{},
+      m_allCellsChanged{false}, m_changedCells{}, m_restartPending{false},
+      m_pendingParameters{}, m_cancelNext{false}, m_pending{} {}
+
+Model::~Model() { cancelNextBoard(); }
 
 Model::Size Model::size() const { return m_size; }
 
 Model::Status Model::status() const { return m_status; }
 
-int Model::width() const { return sizeAsPair(m_size).first; }
+std::uint64_t Model::revision() const { return m_revision; }
 
-int Model::height() const { return sizeAsPair(m_size).second; }
+int Model::width() const { return m_width; }
+
+int Model::height() const { return m_height; }
 
 int Model::minesCount() const { return m_minesCount - m_markedMinesCount; };
 
@@ -54,26 +99,51 @@ int Model::timeInSeconds() const { return m_timeInSeconds; }
 
 bool Model::success() const { return m_success; }
 
-const std::vector<std::vector<Cell>> &Model::cells() const { return m_cells; }
+std::uint64_t Model::seed() const { return m_seed; }
+
+Model::Generation Model::generation() const { return m_generation; }
+
+NoGuessGenerator &Model::generator() { return m_generator; }
+
+const NoGuessGenerator &Model::generator() const { return m_generator; }
+
+int Model::totalMinesCount() const { return m_minesCount; }
+
+bool Model::canUndo() const { return m_journal.canUndo(); }
+
+bool Model::canRedo() const { return m_journal.canRedo(); }
+
+bool Model::restartPending() const { return m_restartPending; }
+
+bool Model::noGuessFallback() const { return m_noGuessFallback; }
+
+const Model::Board &Model::board() const { return m_board; }
+
+Cell Model::cell(int col, int row) const { return m_board.cell(col, row); }
 
 void Model::update() {
+  pollNextBoard();
   switch (m_status) {
   case Status::Ready:
-    if (m_cells.empty()) {
+    if (m_board.empty()) {
       restart();
     }
     return;
   case Status::Started:
     m_startTime = std::chrono::system_clock::now();
     m_status = Status::Running;
-    return;
+    m_revision++;
+    return publish(Change::Start, -1, Status::Started);
   case Status::Running:
     updateTime();
     return;
   case Status::Stopped:
+    m_journal.reopen();
     revealAllMines();
     m_status = Status::Finished;
-    return;
+    m_journal.commit(journalState());
+    m_revision++;
+    return publish(Change::Finish, -1, Status::Stopped);
   case Status::Finished:
     return;
   }
@@ -82,172 +152,616 @@ void Model::update() {
 void Model::cycleSize() {
   switch (m_size) {
   case Size::Size9x9:
-    m_size = Size::Size16x16;
-    break;
+    return setSize(Size::Size16x16);
   case Size::Size16x16:
-    m_size = Size::Size30x16;
-    break;
+    return setSize(Size::Size30x16);
   case Size::Size30x16:
-    m_size = Size::Size9x9;
-    break;
+    if (m_customWidth > 0) {
+      return setSize(Size::Custom);
+    }
+    return setSize(Size::Size9x9);
+  case Size::Custom:
+    return setSize(Size::Size9x9);
   default:
-    break;
+    return;
   }
-  restart();
+}
+
+void Model::setCustomSize(int width, int height, int minesCount) {
+  storeCustomSize(width, height, minesCount);
+  setSize(Size::Custom);
 }
 
 void Model::cycleCellStatus(int col, int row) {
-  auto &cell{m_cells[col][row]};
-  switch (cell.status) {
+  if (m_restartPending) {
+    return;
+  }
+  m_revision++;
+  m_revealedCells.clear();
+  auto status{m_status};
+  auto index{m_board.index(col, row)};
+  auto cell{m_board.cell(index)};
+  if (cell.status() == Cell::Status::Revealed) {
+    return publish(Change::Flag, index, status);
+  }
+  m_journal.begin(journalState());
+  switch (cell.status()) {
   case Cell::Status::Hidden:
-    cell.status = Cell::Status::MarkedAsMine;
+    cell.setStatus(Cell::Status::MarkedAsMine);
     m_markedMinesCount++;
-    return;
+    break;
   case Cell::Status::MarkedAsMine:
     m_markedMinesCount--;
-    cell.status = Cell::Status::MarkedAsSuspect;
-    return;
-  case Cell::Status::MarkedAsSuspect:
-    cell.status = Cell::Status::Hidden;
-    return;
+    cell.setStatus(Cell::Status::MarkedAsSuspect);
+    break;
   default:
-    return;
+  case Cell::Status::MarkedAsSuspect:
+    cell.setStatus(Cell::Status::Hidden);
+    break;
   }
+  setCell(index, cell);
+  checkSuccess();
+  m_journal.commit(journalState());
+  publish(Change::Flag, index, status);
 }
 
 void Model::reveal(int col, int row) {
-  auto &cell = m_cells[col][row];
-  if (cell.status != Cell::Status::Hidden) {
+  if (m_restartPending) {
     return;
   }
-  cell.status = Cell::Status::Revealed;
-  if (cell.type == Cell::Type::Mine) {
-    m_status = Status::Stopped;
-    cell.triggered = true;
-    return;
-  }
-  tryRevealNeighbours(col, row);
-  if (m_status == Status::Ready) {
-    m_status = Status::Started;
-  }
-  m_revealedCellsCount++;
-  if (m_revealedCellsCount == m_cellsToBeRevealed && minesCount() == 0) {
-    m_success = true;
-    m_status = Status::Finished;
+  m_revision++;
+  m_journal.begin(journalState());
+  auto status{m_status};
+  auto index{m_board.index(col, row)};
+  if (m_status == Status::Ready && m_revealedCellsCount == 0) {
+    relocateMine(index);
   }
+  m_revealedCells.clear();
+  revealCell(index);
+  revealFlood();
+  m_journal.commit(journalState());
+  publish(Change::Reveal, index, status);
 }
 
 void Model::tryRevealNeighbours(int col, int row) {
-  auto &cell{m_cells[col][row]};
-  if (cell.status != Cell::Status::Revealed) {
+  if (m_restartPending) {
     return;
   }
-  auto gridSize{sizeAsPair(m_size)};
-  auto width{gridSize.first};
-  auto height{gridSize.second};
-  std::vector<Cell *> neighbours;
-  decltype(Cell::neighbourMinesCount) neighbourMarkedMinesCount{0};
-  for (auto i = col - 1; i <= col + 1; i++) {
-    for (auto j = row - 1; j <= row + 1; j++) {
-      if ((i >= 0 && i < width) && (j >= 0 && j < height)) {
-        auto &neighbour{m_cells[i][j]};
-        if (neighbour.status == Cell::Status::MarkedAsMine) {
-          neighbourMarkedMinesCount++;
-        }
-        neighbours.push_back(&neighbour);
-      }
-    }
+  m_revision++;
+  m_revealedCells.clear();
+  auto status{m_status};
+  auto index{m_board.index(col, row)};
+  if (!neighbourMinesMarked(index)) {
+    return publish(Change::Chord, index, status);
   }
-  if (neighbourMarkedMinesCount != cell.neighbourMinesCount) {
+  m_journal.begin(journalState());
+  revealNeighbours(index);
+  revealFlood();
+  m_journal.commit(journalState());
+  publish(Change::Chord, index, status);
+}
+
+void Model::undo() {
+  if (m_restartPending) {
     return;
   }
-  for (auto &n : neighbours) {
-    reveal(n->col, n->row);
+  Journal::State state;
+  auto status{m_status};
+  auto flip{[this](int index, std::uint8_t mask) { flipCell(index, mask); }};
+  if (m_journal.undo(flip, state)) {
+    restoreState(state);
+    publish(Change::Undo, -1, status);
   }
 }
 
-void Model::setSize(Size size) {
-  if (size == m_size) {
+void Model::redo() {
+  if (m_restartPending) {
     return;
   }
+  Journal::State state;
+  auto status{m_status};
+  auto flip{[this](int index, std::uint8_t mask) { flipCell(index, mask); }};
+  if (m_journal.redo(flip, state)) {
+    restoreState(state);
+    publish(Change::Redo, -1, status);
+  }
+}
+
+bool Model::save(const std::string &path) const {
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  return save(file);
+}
+
+bool Model::save(std::ostream &stream) const {
+  if (m_board.empty()) {
+    return false;
+  }
+  SaveHeader header{};
+  std::memcpy(header.magic, f_saveMagic, sizeof(header.magic));
+  header.width = m_width;
+  header.height = m_height;
+  header.size = static_cast<std::int32_t>(m_size);
+  header.minesCount = m_minesCount;
+  header.markedMinesCount = m_markedMinesCount;
+  header.revealedCellsCount = m_revealedCellsCount;
+  header.status = static_cast<std::int32_t>(m_status);
+  header.success = m_success;
+  header.generation = static_cast<std::int32_t>(m_generation);
+  header.timeInSeconds = m_timeInSeconds;
+  header.layout = static_cast<std::int32_t>(Board::layout);
+  header.seed = m_seed;
+  stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  m_board.store(stream);
+  return static_cast<bool>(stream);
+}
+
+bool Model::load(const std::string &path) {
+  MappedFile file;
+  return file.open(path) && load(std::move(file));
+}
+
+bool Model::load(MappedFile file) {
+  SaveHeader header;
+  Board board;
+  if (file.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, file.data(), sizeof(header));
+  if (std::memcmp(header.magic, f_saveMagic, sizeof(header.magic)) != 0 ||
+      header.width < 1 || header.width > f_maxBoardSide ||
+      header.height < 1 || header.height > f_maxBoardSide ||
+      header.minesCount < 0 ||
+      header.minesCount >= header.width * header.height ||
+      header.size < 0 || header.size > static_cast<int>(Size::Custom) ||
+      header.status < 0 || header.status > static_cast<int>(Status::Finished) ||
+      header.generation < 0 ||
+      header.generation > static_cast<int>(Generation::NoGuess) ||
+      header.layout < 0 ||
+      header.layout > static_cast<int>(BoardLayout::Cells) ||
+      !board.load(std::move(file), sizeof(header),
+                  static_cast<BoardLayout>(header.layout), header.width,
+                  header.height) ||
+      board.minesCount() != header.minesCount ||
+      board.flagsCount() != header.markedMinesCount ||
+      board.revealedSafeCellsCount() != header.revealedCellsCount) {
+    return false;
+  }
+  m_board = std::move(board);
+  m_revision++;
+  auto status{m_status};
+  m_size = static_cast<Size>(header.size);
+  m_width = header.width;
+  m_height = header.height;
+  m_minesCount = header.minesCount;
+  if (m_size == Size::Custom) {
+    m_customWidth = m_width;
+    m_customHeight = m_height;
+    m_customMinesCount = m_minesCount;
+  }
+  m_cellsToBeRevealed = m_width * m_height - m_minesCount;
+  m_markedMinesCount = header.markedMinesCount;
+  m_revealedCellsCount = header.revealedCellsCount;
+  m_status = static_cast<Status>(header.status);
+  m_success = header.success != 0;
+  m_noGuessFallback = false;
+  m_generation = static_cast<Generation>(header.generation);
+  m_seed = header.seed;
+  m_rng.seed(m_seed);
+  m_timeInSeconds = header.timeInSeconds;
+  m_startTime = std::chrono::system_clock::now() -
+                std::chrono::seconds{m_timeInSeconds};
+  m_revealedCells.clear();
+  m_journal.clear();
+  m_restartPending = false;
+  noteAllCellsChanged();
+  publish(Change::Load, -1, status);
+  return true;
+}
+
+void Model::setSize(Size size) {
   m_size = size;
   restart();
 }
 
+void Model::storeCustomSize(int width, int height, int minesCount) {
+  m_customWidth = std::clamp(width, 1, f_maxBoardSide);
+  m_customHeight = std::clamp(height, 1, f_maxBoardSide);
+  m_customMinesCount =
+      std::clamp(minesCount, 0, m_customWidth * m_customHeight - 1);
+}
+
 void Model::restart() {
-  m_cells.clear();
-  m_minesCount = numberOfMines(m_size);
+  if (m_pregeneration && !m_board.empty()) {
+    m_restartPending = true;
+    if (m_pending.valid() && !(m_pendingParameters == requestedParameters())) {
+      m_cancelNext = true;
+    }
+    return pollNextBoard();
+  }
+  auto status{m_status};
+  cancelNextBoard();
+  generateBoard(m_next, requestedParameters(), generateSeed());
+  startNextBoard();
+  publish(Change::Restart, -1, status);
+}
+
+void Model::restart(std::uint64_t seed) {
+  auto status{m_status};
+  cancelNextBoard();
+  generateBoard(m_next, requestedParameters(), seed);
+  startNextBoard();
+  publish(Change::Restart, -1, status);
+}
+
+void Model::restart(int width, int height, int minesCount,
+                    std::uint64_t seed) {
+  storeCustomSize(width, height, minesCount);
+  m_size = Size::Custom;
+  restart(seed);
+}
+
+void Model::setGeneration(Generation generation) {
+  m_generation = generation;
+}
+
+void Model::setPregeneration(bool enabled) {
+  m_pregeneration = enabled;
+  if (!enabled) {
+    cancelNextBoard();
+    if (m_restartPending) {
+      restart();
+    }
+  } else if (!m_pending.valid() && !m_board.empty()) {
+    scheduleNextBoard();
+  }
+}
+
+void Model::subscribe(Listener *listener) {
+  m_listeners.push_back(listener);
+}
+
+void Model::unsubscribe(Listener *listener) {
+  m_listeners.erase(
+      std::remove(m_listeners.begin(), m_listeners.end(), listener),
+      m_listeners.end());
+}
+
+void Model::updateTime() {
+  auto timeInSeconds{
+      static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(
+                           std::chrono::system_clock::now() - m_startTime)
+                           .count())};
+  if (timeInSeconds != m_timeInSeconds) {
+    m_timeInSeconds = timeInSeconds;
+    m_revision++;
+  }
+}
+
+Model::Parameters Model::requestedParameters() const {
+  if (m_size == Size::Custom) {
+    return {m_customWidth, m_customHeight, m_customMinesCount, m_generation};
+  }
+  auto gridSize{sizeAsPair(m_size)};
+  return {gridSize.first, gridSize.second, numberOfMines(m_size),
+          m_generation};
+}
+
+void Model::generateBoard(NextBoard &next, const Parameters &parameters,
+                          std::uint64_t seed) {
+  next.ready = false;
+  next.startIndex = -1;
+  next.fallback = false;
+  if (parameters.generation == Generation::NoGuess) {
+    auto result{m_generator.generate(parameters.width, parameters.height,
+                                     parameters.minesCount, seed,
+                                     &m_cancelNext)};
+    seed = result.seed;
+    next.startIndex = result.startIndex;
+    next.fallback = !result.guessFree;
+  }
+  next.seed = seed;
+  next.rng.seed(seed);
+  next.parameters = parameters;
+  next.board.reset(parameters.width, parameters.height);
+  generateMines(next);
+  next.ready = !m_cancelNext;
+}
+
+void Model::generateMines(NextBoard &next) {
+  auto &board{next.board};
+  auto &minePlane{next.minePlane};
+  auto width{next.parameters.width};
+  auto height{next.parameters.height};
+  auto minesCount{next.parameters.minesCount};
+  auto size{board.size()};
+  auto stride{width + 2};
+  auto sparse{minesCount <= size / 2};
+  auto value{static_cast<std::uint8_t>(sparse ? 1 : 0)};
+  auto count{sparse ? minesCount : size - minesCount};
+  minePlane.assign(static_cast<std::size_t>(stride) * (height + 2), 0);
+  if (!sparse) {
+    for (auto row = 1; row <= height; row++) {
+      std::fill_n(minePlane.begin() + row * stride + 1, width, 1);
+    }
+  }
+  while (count > 0) {
+    if ((count & f_cancelCheckMask) == 0 && m_cancelNext) {
+      return;
+    }
+    auto index{generateRandomIndex(next.rng, size)};
+    auto &mine{
+        minePlane[(board.row(index) + 1) * stride + board.col(index) + 1]};
+    if (mine == value) {
+      continue;
+    }
+    mine = value;
+    count--;
+  }
+  next.neighbourMinesCounts.resize(static_cast<std::size_t>(size));
+  countNeighbourMines(minePlane.data(), width, height,
+                      next.neighbourMinesCounts.data());
+  for (auto row = 0; row < height; row++) {
+    auto mines{minePlane.data() + (row + 1) * stride + 1};
+    for (auto col = 0; col < width; col++) {
+      auto index{board.index(col, row)};
+      Cell cell;
+      cell.setType(mines[col] ? Cell::Type::Mine : Cell::Type::Empty);
+      cell.setNeighbourMinesCount(next.neighbourMinesCounts[index]);
+      board.setCell(index, cell);
+    }
+  }
+}
+
+void Model::startNextBoard() {
+  m_revision++;
+  std::swap(m_board, m_next.board);
+  m_next.ready = false;
+  m_seed = m_next.seed;
+  m_rng = m_next.rng;
+  m_noGuessFallback = m_next.fallback;
+  m_width = m_next.parameters.width;
+  m_height = m_next.parameters.height;
+  m_minesCount = m_next.parameters.minesCount;
   m_cellsToBeRevealed = width() * height() - m_minesCount;
   m_revealedCellsCount = 0;
   m_markedMinesCount = 0;
   m_timeInSeconds = 0;
-  generateCells();
-  generateMines();
+  m_journal.clear();
+  noteAllCellsChanged();
+  m_revealedCells.clear();
+  m_revealedCells.reserve(static_cast<std::size_t>(m_board.size()));
   m_success = false;
   m_status = Status::Ready;
+  m_restartPending = false;
+  if (m_next.startIndex >= 0) {
+    openStartCell(m_next.startIndex);
+  }
+  if (m_pregeneration) {
+    scheduleNextBoard();
+  }
 }
 
-void Model::updateTime() {
-  m_timeInSeconds =
-      static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(
-                           std::chrono::system_clock::now() - m_startTime)
-                           .count());
+void Model::scheduleNextBoard() {
+  m_pendingParameters = requestedParameters();
+  m_pending = std::async(
+      std::launch::async,
+      [this, parameters{m_pendingParameters}, seed{generateSeed()}] {
+        generateBoard(m_next, parameters, seed);
+      });
 }
 
-void Model::generateCells() {
-  auto gridSize{sizeAsPair(m_size)};
-  auto width{gridSize.first};
-  auto height{gridSize.second};
-  for (auto col = 0; col < width; col++) {
-    m_cells.push_back({});
-    for (auto row = 0; row < height; row++) {
-      m_cells[col].push_back(
-          {col, row, 0, Cell::Type::Empty, Cell::Status::Hidden, false});
+void Model::pollNextBoard() {
+  if (m_pending.valid()) {
+    if (m_pending.wait_for(std::chrono::seconds{0}) !=
+        std::future_status::ready) {
+      return;
     }
+    m_pending.get();
+    m_cancelNext = false;
+  }
+  if (!m_restartPending) {
+    return;
+  }
+  if (!m_next.ready || !(m_next.parameters == requestedParameters())) {
+    return scheduleNextBoard();
   }
+  auto status{m_status};
+  startNextBoard();
+  publish(Change::Restart, -1, status);
 }
 
-void Model::generateMines() {
-  auto gridSize{sizeAsPair(m_size)};
-  auto width{gridSize.first};
-  auto height{gridSize.second};
-  for (auto i = 0; i < m_minesCount; i++) {
-    auto pos{generateRandomValue(0, width * height - 1)};
-    auto col = pos % width;
-    auto row = pos / width;
-    m_cells[col][row].type = Cell::Type::Mine;
-  }
-  for (auto col = 0; col < width; col++) {
-    for (auto row = 0; row < height; row++) {
-      m_cells[col][row].neighbourMinesCount = countNeighbourMines(col, row);
-    }
+void Model::cancelNextBoard() {
+  if (m_pending.valid()) {
+    m_cancelNext = true;
+    m_pending.get();
   }
+  m_cancelNext = false;
 }
 
 void Model::revealAllMines() {
-  for (auto &col : m_cells) {
-    for (auto &cell : col) {
-      if (cell.type == Cell::Type::Mine &&
-          cell.status != Cell::Status::MarkedAsMine) {
-        cell.status = Cell::Status::Revealed;
-      }
+  m_board.revealAllMines([this](int index, std::uint8_t mask) {
+    m_journal.record(index, mask);
+    noteChangedCell(index);
+  });
+}
+
+void Model::revealCell(int index) {
+  auto cell{m_board.cell(index)};
+  if (cell.status() != Cell::Status::Hidden) {
+    return;
+  }
+  cell.setStatus(Cell::Status::Revealed);
+  if (cell.type() == Cell::Type::Mine) {
+    m_status = Status::Stopped;
+    cell.setTriggered(true);
+    setCell(index, cell);
+    return;
+  }
+  setCell(index, cell);
+  m_revealedCells.push_back(index);
+}
+
+void Model::revealNeighbours(int index) {
+  auto col{m_board.col(index)};
+  auto row{m_board.row(index)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, m_board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, m_board.height() - 1)};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      revealCell(m_board.index(i, j));
     }
   }
 }
 
-int Model::countNeighbourMines(int col, int row) {
-  auto neighbourMinesCount{0};
-  auto gridSize{sizeAsPair(m_size)};
-  auto width{gridSize.first};
-  auto height{gridSize.second};
-  for (auto j = col - 1; j <= col + 1; j++) {
-    for (auto z = row - 1; z <= row + 1; z++) {
-      if ((j >= 0 && j < width) && (z >= 0 && z < height)) {
-        if (m_cells[j][z].type == Cell::Type::Mine) {
-          neighbourMinesCount++;
-        }
+void Model::revealFlood() {
+  for (std::size_t i = 0; i < m_revealedCells.size(); i++) {
+    auto index{m_revealedCells[i]};
+    if (neighbourMinesMarked(index)) {
+      revealNeighbours(index);
+    }
+  }
+  if (m_revealedCells.empty()) {
+    return;
+  }
+  if (m_status == Status::Ready) {
+    m_status = Status::Started;
+  }
+  m_revealedCellsCount += static_cast<int>(m_revealedCells.size());
+  checkSuccess();
+}
+
+void Model::checkSuccess() {
+  if (m_status != Status::Stopped &&
+      m_revealedCellsCount == m_cellsToBeRevealed && minesCount() == 0) {
+    m_success = true;
+    m_status = Status::Finished;
+  }
+}
+
+bool Model::neighbourMinesMarked(int index) const {
+  auto cell{m_board.cell(index)};
+  if (cell.status() != Cell::Status::Revealed) {
+    return false;
+  }
+  auto col{m_board.col(index)};
+  auto row{m_board.row(index)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, m_board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, m_board.height() - 1)};
+  auto neighbourMarkedMinesCount{0};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      if (m_board.cell(i, j).status() == Cell::Status::MarkedAsMine) {
+        neighbourMarkedMinesCount++;
       }
     }
   }
-  return neighbourMinesCount;
+  return neighbourMarkedMinesCount == cell.neighbourMinesCount();
+}
+
+void Model::relocateMine(int index) {
+  auto cell{m_board.cell(index)};
+  if (cell.type() != Cell::Type::Mine ||
+      cell.status() != Cell::Status::Hidden ||
+      m_minesCount >= m_board.size()) {
+    return;
+  }
+  auto target{index};
+  while (m_board.cell(target).type() == Cell::Type::Mine) {
+    target = generateRandomIndex(m_rng, m_board.size());
+  }
+  cell.setType(Cell::Type::Empty);
+  setCell(index, cell);
+  addNeighbourMines(index, -1);
+  auto targetCell{m_board.cell(target)};
+  targetCell.setType(Cell::Type::Mine);
+  setCell(target, targetCell);
+  addNeighbourMines(target, 1);
+}
+
+void Model::addNeighbourMines(int index, int count) {
+  auto col{m_board.col(index)};
+  auto row{m_board.row(index)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, m_board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, m_board.height() - 1)};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      auto neighbourIndex{m_board.index(i, j)};
+      auto neighbour{m_board.cell(neighbourIndex)};
+      neighbour.setNeighbourMinesCount(neighbour.neighbourMinesCount() +
+                                       count);
+      setCell(neighbourIndex, neighbour);
+    }
+  }
+}
+
+void Model::openStartCell(int index) {
+  m_revealedCells.clear();
+  revealCell(index);
+  revealFlood();
+  if (m_status == Status::Started) {
+    m_status = Status::Ready;
+  }
+}
+
+void Model::setCell(int index, Cell cell) {
+  m_journal.record(index, static_cast<std::uint8_t>(
+                              m_board.cell(index).bits() ^ cell.bits()));
+  m_board.setCell(index, cell);
+  noteChangedCell(index);
+}
+
+void Model::flipCell(int index, std::uint8_t mask) {
+  m_board.setCell(index, Cell{static_cast<std::uint8_t>(
+                             m_board.cell(index).bits() ^ mask)});
+  noteChangedCell(index);
+}
+
+void Model::noteChangedCell(int index) {
+  if (m_listeners.empty() || m_allCellsChanged) {
+    return;
+  }
+  if (m_changedCells.size() >=
+      static_cast<std::size_t>(m_board.size() / f_changedCellsFraction)) {
+    return noteAllCellsChanged();
+  }
+  m_changedCells.push_back(index);
+}
+
+void Model::noteAllCellsChanged() {
+  m_allCellsChanged = true;
+  m_changedCells.clear();
+}
+
+void Model::publish(Change change, int index, Status previousStatus) {
+  Changes changes{change, index, m_changedCells, m_allCellsChanged,
+                  previousStatus, m_status, m_revealedCellsCount,
+                  m_markedMinesCount};
+  for (auto listener : m_listeners) {
+    listener->onChanges(changes);
+  }
+  m_allCellsChanged = false;
+  m_changedCells.clear();
+}
+
+Journal::State Model::journalState() const {
+  return {static_cast<int>(m_status), m_revealedCellsCount,
+          m_markedMinesCount, m_success};
+}
+
+void Model::restoreState(const Journal::State &state) {
+  m_revision++;
+  m_revealedCells.clear();
+  m_status = static_cast<Status>(state.status);
+  m_revealedCellsCount = state.revealedCellsCount;
+  m_markedMinesCount = state.markedMinesCount;
+  m_success = state.success;
+  if (m_status == Status::Ready) {
+    m_timeInSeconds = 0;
+  }
 }
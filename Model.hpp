@@ -1,53 +1,196 @@
 #ifndef MINESWEEPER_MODEL_HPP
 #define MINESWEEPER_MODEL_HPP
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <future>
+#include <ostream>
+#include <random>
+#include <string>
 #include <vector>
-
-#include "Cell.hpp"
+#ifdef MINESWEEPER_BITBOARD
+#include "BitBoard.hpp"
+#else
+#include "Board.hpp"
+#endif
+#include "Journal.hpp"
+#include "MappedFile.hpp"
+#include "NoGuessGenerator.hpp"
 
 class Model {
 public:
+#ifdef MINESWEEPER_BITBOARD
+  using Board = BitBoard;
+#else
+  using Board = ::Board;
+#endif
+
   enum class Status { Ready, Started, Running, Stopped, Finished };
-  enum class Size { Size9x9, Size16x16, Size30x16 };
+  enum class Size { Size9x9, Size16x16, Size30x16, Custom };
+  enum class Generation { Random, NoGuess };
+  enum class Change {
+    Restart,
+    Load,
+    Start,
+    Reveal,
+    Chord,
+    Flag,
+    Finish,
+    Undo,
+    Redo
+  };
+
+  // What one operation did to the model: the cells whose bits it changed, or
+  // every cell, and the status and counters it left behind. Cells may repeat.
+  struct Changes {
+    Change change;
+    int index;
+    const std::vector<int> &cells;
+    bool allCells;
+    Status previousStatus;
+    Status status;
+    int revealedCellsCount;
+    int markedMinesCount;
+  };
+
+  class Listener {
+  public:
+    virtual ~Listener() = default;
+    virtual void onChanges(const Changes &changes) = 0;
+  };
 
   Model();
+  ~Model();
 
   Size size() const;
   Status status() const;
+  std::uint64_t revision() const;
   int width() const;
   int height() const;
   int minesCount() const;
   int timeInSeconds() const;
   bool success() const;
+  std::uint64_t seed() const;
+  Generation generation() const;
+  NoGuessGenerator &generator();
+  const NoGuessGenerator &generator() const;
+  int totalMinesCount() const;
+  bool canUndo() const;
+  bool canRedo() const;
+  bool restartPending() const;
+  bool noGuessFallback() const;
 
-  const std::vector<std::vector<Cell>> &cells() const;
+  const Board &board() const;
+  Cell cell(int col, int row) const;
 
   void update();
   void restart();
+  void restart(std::uint64_t seed);
+  void restart(int width, int height, int minesCount, std::uint64_t seed);
   void cycleSize();
+  void setCustomSize(int width, int height, int minesCount);
+  void setGeneration(Generation generation);
+  void setPregeneration(bool enabled);
+  void subscribe(Listener *listener);
+  void unsubscribe(Listener *listener);
   void cycleCellStatus(int col, int row);
   void reveal(int col, int row);
   void tryRevealNeighbours(int col, int row);
+  void undo();
+  void redo();
+  bool save(const std::string &path) const;
+  bool save(std::ostream &stream) const;
+  bool load(const std::string &path);
+  bool load(MappedFile file);
 
 private:
+  // A board generated ahead of a restart, with the scratch buffers used to
+  // build it and the random generator state it leaves behind.
+  struct Parameters {
+    int width{0};
+    int height{0};
+    int minesCount{0};
+    Generation generation{Generation::Random};
+
+    bool operator==(const Parameters &other) const {
+      return width == other.width && height == other.height &&
+             minesCount == other.minesCount && generation == other.generation;
+    }
+  };
+
+  struct NextBoard {
+    Board board;
+    std::vector<std::uint8_t> minePlane;
+    std::vector<std::uint8_t> neighbourMinesCounts;
+    std::mt19937_64 rng;
+    std::uint64_t seed{0};
+    int startIndex{-1};
+    Parameters parameters;
+    bool fallback{false};
+    bool ready{false};
+  };
+
   void updateTime();
-  void generateCells();
-  void generateMines();
+  Parameters requestedParameters() const;
+  void generateBoard(NextBoard &next, const Parameters &parameters,
+                     std::uint64_t seed);
+  void generateMines(NextBoard &next);
+  void startNextBoard();
+  void scheduleNextBoard();
+  void pollNextBoard();
+  void cancelNextBoard();
   void revealAllMines();
   void setSize(Size size);
-  int countNeighbourMines(int col, int row);
+  void storeCustomSize(int width, int height, int minesCount);
+  void revealCell(int index);
+  void revealNeighbours(int index);
+  void revealFlood();
+  void checkSuccess();
+  bool neighbourMinesMarked(int index) const;
+  void relocateMine(int index);
+  void addNeighbourMines(int index, int count);
+  void openStartCell(int index);
+  void setCell(int index, Cell cell);
+  void flipCell(int index, std::uint8_t mask);
+  void noteChangedCell(int index);
+  void noteAllCellsChanged();
+  void publish(Change change, int index, Status previousStatus);
+  Journal::State journalState() const;
+  void restoreState(const Journal::State &state);
 
   Status m_status;
+  std::uint64_t m_revision;
   Size m_size;
+  int m_width;
+  int m_height;
+  int m_customWidth;
+  int m_customHeight;
+  int m_customMinesCount;
   int m_timeInSeconds;
   int m_minesCount;
   int m_markedMinesCount;
   int m_revealedCellsCount;
   int m_cellsToBeRevealed;
   bool m_success;
-  std::vector<std::vector<Cell>> m_cells;
+  bool m_noGuessFallback;
+  Generation m_generation;
+  NoGuessGenerator m_generator;
+  std::uint64_t m_seed;
+  std::mt19937_64 m_rng;
+  Board m_board;
+  std::vector<int> m_revealedCells;
   std::chrono::system_clock::time_point m_startTime;
+  Journal m_journal;
+  bool m_pregeneration;
+  NextBoard m_next;
+  std::vector<Listener *> m_listeners;
+  bool m_allCellsChanged;
+  std::vector<int> m_changedCells;
+  bool m_restartPending;
+  Parameters m_pendingParameters;
+  std::atomic<bool> m_cancelNext;
+  std::future<void> m_pending;
 };
 
 #endif
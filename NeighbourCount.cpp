@@ -0,0 +1,77 @@
+#include "NeighbourCount.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINESWEEPER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+inline std::uint8_t boxSum(const std::uint8_t *top, const std::uint8_t *middle,
+                           const std::uint8_t *bottom, int col) {
+  auto sum{0};
+  for (auto i = col; i < col + 3; i++) {
+    sum += top[i] + middle[i] + bottom[i];
+  }
+  return static_cast<std::uint8_t>(sum);
+}
+
+inline void countRowScalar(const std::uint8_t *top, const std::uint8_t *middle,
+                           const std::uint8_t *bottom, int firstCol,
+                           int width, std::uint8_t *counts) {
+  for (auto col = firstCol; col < width; col++) {
+    counts[col] = boxSum(top, middle, bottom, col);
+  }
+}
+
+#ifdef MINESWEEPER_SSE2
+inline __m128i columnSum(const std::uint8_t *top, const std::uint8_t *middle,
+                         const std::uint8_t *bottom, int col) {
+  auto t{_mm_loadu_si128(reinterpret_cast<const __m128i *>(top + col))};
+  auto m{_mm_loadu_si128(reinterpret_cast<const __m128i *>(middle + col))};
+  auto b{_mm_loadu_si128(reinterpret_cast<const __m128i *>(bottom + col))};
+  return _mm_add_epi8(_mm_add_epi8(t, m), b);
+}
+
+inline int countRowSse2(const std::uint8_t *top, const std::uint8_t *middle,
+                        const std::uint8_t *bottom, int width,
+                        std::uint8_t *counts) {
+  auto col{0};
+  for (; col + 16 <= width; col += 16) {
+    auto left{columnSum(top, middle, bottom, col)};
+    auto centre{columnSum(top, middle, bottom, col + 1)};
+    auto right{columnSum(top, middle, bottom, col + 2)};
+    auto sum{_mm_add_epi8(_mm_add_epi8(left, centre), right)};
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(counts + col), sum);
+  }
+  return col;
+}
+#endif
+} // namespace
+
+void countNeighbourMines(const std::uint8_t *mines, int width, int height,
+                         std::uint8_t *counts) {
+#ifdef MINESWEEPER_SSE2
+  auto stride{width + 2};
+  for (auto row = 0; row < height; row++) {
+    auto top{mines + row * stride};
+    auto rowCounts{counts + row * width};
+    auto col{countRowSse2(top, top + stride, top + 2 * stride, width,
+                          rowCounts)};
+    countRowScalar(top, top + stride, top + 2 * stride, col, width,
+                   rowCounts);
+  }
+#else
+  countNeighbourMinesScalar(mines, width, height, counts);
+#endif
+}
+
+void countNeighbourMinesScalar(const std::uint8_t *mines, int width,
+                               int height, std::uint8_t *counts) {
+  auto stride{width + 2};
+  for (auto row = 0; row < height; row++) {
+    auto top{mines + row * stride};
+    countRowScalar(top, top + stride, top + 2 * stride, 0, width,
+                   counts + row * width);
+  }
+}
@@ -0,0 +1,14 @@
+#ifndef MINESWEEPER_NEIGHBOUR_COUNT_HPP
+#define MINESWEEPER_NEIGHBOUR_COUNT_HPP
+
+#include <cstdint>
+
+// Writes the 3x3 box sum of a zero-padded (width + 2) x (height + 2) plane of
+// 0/1 mine bytes into a width x height plane of neighbour mines counts.
+void countNeighbourMines(const std::uint8_t *mines, int width, int height,
+                         std::uint8_t *counts);
+
+void countNeighbourMinesScalar(const std::uint8_t *mines, int width,
+                               int height, std::uint8_t *counts);
+
+#endif
@@ -0,0 +1,134 @@
+#include "NoGuessGenerator.hpp"
+#include "Model.hpp"
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+namespace {
+constexpr std::chrono::milliseconds f_timeBudget{1000};
+constexpr auto f_noAttempt{std::numeric_limits<int>::max()};
+
+int findStartCell(const Model::Board &board) {
+  auto centreCol{board.width() / 2};
+  auto centreRow{board.height() / 2};
+  auto startIndex{-1};
+  auto startDistance{0LL};
+  for (auto index = 0; index < board.size(); index++) {
+    auto cell{board.cell(index)};
+    if (cell.type() == Cell::Type::Mine || cell.neighbourMinesCount() != 0) {
+      continue;
+    }
+    auto col{static_cast<long long>(board.col(index) - centreCol)};
+    auto row{static_cast<long long>(board.row(index) - centreRow)};
+    auto distance{col * col + row * row};
+    if (startIndex < 0 || distance < startDistance) {
+      startIndex = index;
+      startDistance = distance;
+    }
+  }
+  return startIndex;
+}
+
+int solvableStartCell(Model &model, Solver &solver) {
+  auto &board{model.board()};
+  auto startIndex{findStartCell(board)};
+  if (startIndex < 0) {
+    return -1;
+  }
+  model.reveal(board.col(startIndex), board.row(startIndex));
+  solver.solve();
+  while (auto index{solver.nextSafeCell()}) {
+    model.reveal(board.col(*index), board.row(*index));
+    solver.solve();
+  }
+  return board.allSafeCellsRevealed() ? startIndex : -1;
+}
+} // namespace
+
+NoGuessGenerator::NoGuessGenerator()
+    : m_threads{static_cast<int>(std::thread::hardware_concurrency())},
+      m_samples{} {
+  m_threads = std::max(m_threads, 1);
+}
+
+int NoGuessGenerator::threads() const { return m_threads; }
+
+void NoGuessGenerator::setThreads(int threads) {
+  m_threads = std::max(threads, 1);
+}
+
+const std::vector<double> &NoGuessGenerator::samples() const {
+  return m_samples;
+}
+
+void NoGuessGenerator::clearSamples() { m_samples.clear(); }
+
+NoGuessGenerator::Result
+NoGuessGenerator::generate(int width, int height, int minesCount,
+                           std::uint64_t baseSeed,
+                           const std::atomic<bool> *cancel) {
+  auto start{std::chrono::steady_clock::now()};
+  auto deadline{start + f_timeBudget};
+  auto stopped{[&] {
+    return (cancel && *cancel) || std::chrono::steady_clock::now() >= deadline;
+  }};
+  std::atomic<int> acceptedAttempt{f_noAttempt};
+  std::atomic<int> attempts{0};
+  std::vector<int> startCells(static_cast<std::size_t>(m_threads), -1);
+  auto search{[&](int thread) {
+    Model candidate;
+    Solver solver{candidate};
+    for (auto attempt = thread;
+         attempt < acceptedAttempt && !stopped();
+         attempt += m_threads) {
+      attempts++;
+      candidate.restart(width, height, minesCount,
+                        baseSeed + static_cast<std::uint64_t>(attempt));
+      auto startIndex{solvableStartCell(candidate, solver)};
+      if (startIndex < 0) {
+        continue;
+      }
+      startCells[thread] = startIndex;
+      auto accepted{acceptedAttempt.load()};
+      while (attempt < accepted &&
+             !acceptedAttempt.compare_exchange_weak(accepted, attempt)) {
+      }
+      return;
+    }
+  }};
+  std::vector<std::thread> threads;
+  for (auto thread = 1; thread < m_threads; thread++) {
+    threads.emplace_back(search, thread);
+  }
+  search(0);
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  Result result;
+  result.attempts = attempts;
+  result.seed = baseSeed;
+  if (acceptedAttempt < f_noAttempt) {
+    result.seed += static_cast<std::uint64_t>(acceptedAttempt.load());
+    result.startIndex = startCells[acceptedAttempt % m_threads];
+    result.guessFree = true;
+  }
+  m_samples.push_back(std::chrono::duration<double, std::milli>(
+                          std::chrono::steady_clock::now() - start)
+                          .count());
+  return result;
+}
+
+double NoGuessGenerator::percentile(std::vector<double> samples,
+                                    double fraction) {
+  if (samples.empty()) {
+    return 0.;
+  }
+  auto rank{static_cast<std::size_t>(fraction *
+                                     static_cast<double>(samples.size() - 1))};
+  std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+  return samples[rank];
+}
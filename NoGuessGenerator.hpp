@@ -0,0 +1,41 @@
+#ifndef MINESWEEPER_NO_GUESS_GENERATOR_HPP
+#define MINESWEEPER_NO_GUESS_GENERATOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Searches for boards the solver can clear without guessing, starting from the
+// empty cell closest to the centre. Candidate seeds are tried speculatively on
+// several threads, and the lowest accepted attempt wins, so the result only
+// depends on the base seed. The search stops when the cancel flag is raised or
+// its time budget runs out, and then the result carries the base seed and is
+// not guess-free.
+class NoGuessGenerator {
+public:
+  struct Result {
+    std::uint64_t seed{0};
+    int startIndex{-1};
+    int attempts{0};
+    bool guessFree{false};
+  };
+
+  NoGuessGenerator();
+
+  int threads() const;
+  void setThreads(int threads);
+  const std::vector<double> &samples() const;
+  void clearSamples();
+
+  Result generate(int width, int height, int minesCount,
+                  std::uint64_t baseSeed,
+                  const std::atomic<bool> *cancel = nullptr);
+
+  static double percentile(std::vector<double> samples, double fraction);
+
+private:
+  int m_threads;
+  std::vector<double> m_samples;
+};
+
+#endif
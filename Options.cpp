@@ -0,0 +1,62 @@
+#include "Options.hpp"
+#include "Model.hpp"
+
+#include <cstdlib>
+
+Options parseOptions(int argc, char *argv[]) {
+  Options options;
+  for (auto i = 1; i + 1 < argc; i += 2) {
+    std::string option{argv[i]};
+    auto value{std::atoi(argv[i + 1])};
+    if (option == "--width") {
+      options.width = value;
+    } else if (option == "--height") {
+      options.height = value;
+    } else if (option == "--mines") {
+      options.minesCount = value;
+    } else if (option == "--seed") {
+      options.hasSeed = true;
+      options.seed = std::strtoull(argv[i + 1], nullptr, 10);
+    } else if (option == "--generation") {
+      options.noGuess = std::string{argv[i + 1]} == "no-guess";
+    } else if (option == "--games") {
+      options.games = value;
+    } else if (option == "--threads") {
+      options.threads = value;
+    } else if (option == "--render") {
+      options.continuousRendering = std::string{argv[i + 1]} == "continuous";
+    } else if (option == "--output") {
+      options.output = argv[i + 1];
+    } else if (option == "--profile") {
+      options.profile = argv[i + 1];
+    } else if (option == "--latency") {
+      options.latency = argv[i + 1];
+    } else if (option == "--record") {
+      options.record = argv[i + 1];
+    } else if (option == "--replay") {
+      options.replay = argv[i + 1];
+    } else if (option == "--save") {
+      options.save = argv[i + 1];
+    } else if (option == "--speed") {
+      options.realTimeReplay = std::string{argv[i + 1]} == "realtime";
+    }
+  }
+  return options;
+}
+
+void applyOptions(const Options &options, Model &model) {
+  if (options.noGuess) {
+    model.setGeneration(Model::Generation::NoGuess);
+  }
+  if (options.width > 0 && options.height > 0) {
+    if (options.hasSeed) {
+      return model.restart(options.width, options.height, options.minesCount,
+                           options.seed);
+    }
+    return model.setCustomSize(options.width, options.height,
+                               options.minesCount);
+  }
+  if (options.hasSeed) {
+    model.restart(options.seed);
+  }
+}
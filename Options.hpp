@@ -0,0 +1,31 @@
+#ifndef MINESWEEPER_OPTIONS_HPP
+#define MINESWEEPER_OPTIONS_HPP
+
+#include <cstdint>
+#include <string>
+
+class Model;
+
+struct Options {
+  int width{0};
+  int height{0};
+  int minesCount{0};
+  bool hasSeed{false};
+  std::uint64_t seed{0};
+  bool noGuess{false};
+  int games{1};
+  int threads{0};
+  bool continuousRendering{false};
+  std::string output;
+  std::string profile;
+  std::string latency;
+  std::string record;
+  std::string replay;
+  bool realTimeReplay{false};
+  std::string save{"minesweeper.save"};
+};
+
+Options parseOptions(int argc, char *argv[]);
+void applyOptions(const Options &options, Model &model);
+
+#endif
@@ -0,0 +1,59 @@
+#include "QuadBatch.hpp"
+
+namespace {
+constexpr auto f_quadVertices{4};
+} // namespace
+
+QuadBatch::QuadBatch() : m_vertices{sf::Quads}, m_owners{} {}
+
+bool QuadBatch::empty() const { return m_owners.empty(); }
+
+void QuadBatch::clear() {
+  m_vertices.clear();
+  m_owners.clear();
+}
+
+int QuadBatch::add(int owner) {
+  auto slot{static_cast<int>(m_owners.size())};
+  m_owners.push_back(owner);
+  m_vertices.resize(m_owners.size() * f_quadVertices);
+  return slot;
+}
+
+int QuadBatch::remove(int slot) {
+  auto last{static_cast<int>(m_owners.size()) - 1};
+  auto moved{-1};
+  if (slot != last) {
+    for (auto i = 0; i < f_quadVertices; i++) {
+      m_vertices[slot * f_quadVertices + i] =
+          m_vertices[last * f_quadVertices + i];
+    }
+    m_owners[slot] = m_owners[last];
+    moved = m_owners[slot];
+  }
+  m_owners.pop_back();
+  m_vertices.resize(m_owners.size() * f_quadVertices);
+  return moved;
+}
+
+void QuadBatch::setQuad(int slot, const sf::FloatRect &rect,
+                        const sf::Color &color,
+                        const sf::FloatRect &textureRect) {
+  auto *quad{&m_vertices[slot * f_quadVertices]};
+  auto right{rect.left + rect.width};
+  auto bottom{rect.top + rect.height};
+  auto textureRight{textureRect.left + textureRect.width};
+  auto textureBottom{textureRect.top + textureRect.height};
+  quad[0] = {{rect.left, rect.top}, color, {textureRect.left, textureRect.top}};
+  quad[1] = {{right, rect.top}, color, {textureRight, textureRect.top}};
+  quad[2] = {{right, bottom}, color, {textureRight, textureBottom}};
+  quad[3] = {{rect.left, bottom}, color, {textureRect.left, textureBottom}};
+}
+
+void QuadBatch::draw(sf::RenderTarget &target,
+                     const sf::Texture *texture) const {
+  if (empty()) {
+    return;
+  }
+  target.draw(m_vertices, sf::RenderStates{texture});
+}
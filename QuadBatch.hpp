@@ -0,0 +1,28 @@
+#ifndef MINESWEEPER_QUAD_BATCH_HPP
+#define MINESWEEPER_QUAD_BATCH_HPP
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <vector>
+
+// Textured quads owned by board cells, drawn in a single call. Removing a
+// quad moves the last one into its slot.
+class QuadBatch {
+public:
+  QuadBatch();
+
+  bool empty() const;
+
+  void clear();
+  int add(int owner);
+  int remove(int slot);
+  void setQuad(int slot, const sf::FloatRect &rect, const sf::Color &color,
+               const sf::FloatRect &textureRect);
+  void draw(sf::RenderTarget &target, const sf::Texture *texture) const;
+
+private:
+  sf::VertexArray m_vertices;
+  std::vector<int> m_owners;
+};
+
+#endif
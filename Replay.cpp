@@ -0,0 +1,259 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace {
+constexpr char f_magic[]{'M', 'S', 'R', '1'};
+constexpr auto f_magicSize{sizeof(f_magic)};
+
+inline void writeVarint(std::ostream &stream, std::uint64_t value) {
+  while (value >= 0x80) {
+    stream.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  stream.put(static_cast<char>(value));
+}
+
+inline bool readVarint(std::istream &stream, std::uint64_t &value) {
+  value = 0;
+  for (auto shift = 0; shift < 64; shift += 7) {
+    auto byte{stream.get()};
+    if (byte == std::char_traits<char>::eof()) {
+      return false;
+    }
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline std::uint64_t zigzag(int value) {
+  auto wide{static_cast<std::int64_t>(value)};
+  return (static_cast<std::uint64_t>(wide) << 1) ^
+         static_cast<std::uint64_t>(wide >> 63);
+}
+
+inline int unzigzag(std::uint64_t value) {
+  return static_cast<int>(static_cast<std::int64_t>(value >> 1) ^
+                          -static_cast<std::int64_t>(value & 1));
+}
+
+inline bool isCellAction(ReplayAction action) {
+  return action == ReplayAction::Reveal || action == ReplayAction::Flag ||
+         action == ReplayAction::Chord;
+}
+} // namespace
+
+ReplayRecorder::ReplayRecorder(Model &model)
+    : m_model{model}, m_file{}, m_time{}, m_board{}, m_hasBoard{false},
+      m_col{0}, m_row{0} {
+  m_model.subscribe(this);
+}
+
+ReplayRecorder::~ReplayRecorder() { m_model.unsubscribe(this); }
+
+bool ReplayRecorder::open(const std::string &path) {
+  m_file.open(path, std::ios::binary | std::ios::trunc);
+  if (!m_file) {
+    return false;
+  }
+  m_file.write(f_magic, f_magicSize);
+  m_time = std::chrono::steady_clock::now();
+  m_hasBoard = false;
+  m_col = 0;
+  m_row = 0;
+  return true;
+}
+
+void ReplayRecorder::onChanges(const Model::Changes &changes) {
+  if (!m_file.is_open()) {
+    return;
+  }
+  auto &board{m_model.board()};
+  auto col{changes.index < 0 ? 0 : board.col(changes.index)};
+  auto row{changes.index < 0 ? 0 : board.row(changes.index)};
+  switch (changes.change) {
+  case Model::Change::Restart:
+    return record(ReplayAction::Restart, col, row);
+  case Model::Change::Reveal:
+    return record(ReplayAction::Reveal, col, row);
+  case Model::Change::Flag:
+    return record(ReplayAction::Flag, col, row);
+  case Model::Change::Chord:
+    return record(ReplayAction::Chord, col, row);
+  case Model::Change::Undo:
+    return record(ReplayAction::Undo, col, row);
+  case Model::Change::Redo:
+    return record(ReplayAction::Redo, col, row);
+  case Model::Change::Load:
+    return recordLoad();
+  default:
+    return;
+  }
+}
+
+ReplayRecorder::BoardKey ReplayRecorder::boardKey(const Model &model) {
+  return {model.width(), model.height(), model.totalMinesCount(),
+          static_cast<int>(model.generation()), model.seed()};
+}
+
+void ReplayRecorder::record(ReplayAction action, int col, int row) {
+  auto board{boardKey(m_model)};
+  if (action == ReplayAction::Restart || !m_hasBoard ||
+      board.width != m_board.width || board.height != m_board.height ||
+      board.minesCount != m_board.minesCount ||
+      board.generation != m_board.generation || board.seed != m_board.seed) {
+    writeRecord(ReplayAction::Restart);
+    writeVarint(m_file, static_cast<std::uint64_t>(board.width));
+    writeVarint(m_file, static_cast<std::uint64_t>(board.height));
+    writeVarint(m_file, static_cast<std::uint64_t>(board.minesCount));
+    writeVarint(m_file, static_cast<std::uint64_t>(board.generation));
+    writeVarint(m_file, board.seed);
+    m_board = board;
+    m_hasBoard = true;
+  }
+  if (action != ReplayAction::Restart) {
+    writeRecord(action);
+  }
+  if (isCellAction(action)) {
+    writeVarint(m_file, zigzag(col - m_col));
+    writeVarint(m_file, zigzag(row - m_row));
+    m_col = col;
+    m_row = row;
+  }
+  m_file.flush();
+}
+
+void ReplayRecorder::recordLoad() {
+  std::ostringstream game;
+  if (!m_model.save(game)) {
+    return;
+  }
+  auto bytes{game.str()};
+  writeRecord(ReplayAction::Load);
+  writeVarint(m_file, bytes.size());
+  m_file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  m_board = boardKey(m_model);
+  m_hasBoard = true;
+  m_file.flush();
+}
+
+void ReplayRecorder::writeRecord(ReplayAction action) {
+  auto elapsed{std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - m_time)};
+  m_time += elapsed;
+  m_file.put(static_cast<char>(action));
+  writeVarint(m_file, static_cast<std::uint64_t>(elapsed.count()));
+}
+
+ReplayPlayer::ReplayPlayer(Model &model) : m_model{model}, m_file{} {}
+
+bool ReplayPlayer::open(const std::string &path) {
+  m_file.open(path, std::ios::binary);
+  char magic[f_magicSize];
+  return m_file.read(magic, f_magicSize) &&
+         std::equal(magic, magic + f_magicSize, f_magic);
+}
+
+ReplayPlayer::Summary ReplayPlayer::play(bool realTime) {
+  using Clock = std::chrono::steady_clock;
+  Summary summary;
+  auto start{Clock::now()};
+  auto due{start};
+  auto modelTime{Clock::duration::zero()};
+  auto col{0};
+  auto row{0};
+  for (auto tag{m_file.get()}; tag != std::char_traits<char>::eof();
+       tag = m_file.get()) {
+    auto action{static_cast<ReplayAction>(tag)};
+    auto count{action == ReplayAction::Restart ? 5
+               : isCellAction(action)          ? 2
+                                               : 0};
+    std::uint64_t elapsed{0};
+    std::uint64_t values[5]{};
+    auto complete{tag <= static_cast<int>(ReplayAction::Load) &&
+                  readVarint(m_file, elapsed)};
+    for (auto i = 0; complete && i < count; i++) {
+      complete = readVarint(m_file, values[i]);
+    }
+    if (!complete) {
+      summary.truncated = true;
+      break;
+    }
+    due += std::chrono::milliseconds(elapsed);
+    if (realTime) {
+      std::this_thread::sleep_until(due);
+    }
+    auto finished{m_model.status() == Model::Status::Finished};
+    auto before{Clock::now()};
+    if (action == ReplayAction::Restart) {
+      restart(static_cast<int>(values[0]), static_cast<int>(values[1]),
+              static_cast<int>(values[2]), static_cast<int>(values[3]),
+              values[4]);
+      summary.restarts++;
+    } else if (action == ReplayAction::Load) {
+      if (!load()) {
+        summary.truncated = true;
+        break;
+      }
+      summary.restarts++;
+    } else {
+      col += unzigzag(values[0]);
+      row += unzigzag(values[1]);
+      apply(action, col, row);
+      summary.actions++;
+    }
+    m_model.update();
+    modelTime += Clock::now() - before;
+    if (!finished && m_model.status() == Model::Status::Finished) {
+      m_model.success() ? summary.wins++ : summary.losses++;
+    }
+  }
+  summary.modelSeconds = std::chrono::duration<double>(modelTime).count();
+  summary.wallSeconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  return summary;
+}
+
+void ReplayPlayer::restart(int width, int height, int minesCount,
+                           int generation, std::uint64_t seed) {
+  m_model.setGeneration(static_cast<Model::Generation>(generation));
+  if (width != m_model.width() || height != m_model.height() ||
+      minesCount != m_model.totalMinesCount()) {
+    return m_model.restart(width, height, minesCount, seed);
+  }
+  m_model.restart(seed);
+}
+
+bool ReplayPlayer::load() {
+  std::uint64_t size{0};
+  MappedFile game;
+  return readVarint(m_file, size) &&
+         game.read(m_file, static_cast<std::size_t>(size)) &&
+         m_model.load(std::move(game));
+}
+
+void ReplayPlayer::apply(ReplayAction action, int col, int row) {
+  if (isCellAction(action) && !m_model.board().contains(col, row)) {
+    return;
+  }
+  switch (action) {
+  case ReplayAction::Reveal:
+    return m_model.reveal(col, row);
+  case ReplayAction::Flag:
+    return m_model.cycleCellStatus(col, row);
+  case ReplayAction::Chord:
+    return m_model.tryRevealNeighbours(col, row);
+  case ReplayAction::Undo:
+    return m_model.undo();
+  case ReplayAction::Redo:
+    return m_model.redo();
+  default:
+    return;
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef MINESWEEPER_REPLAY_HPP
+#define MINESWEEPER_REPLAY_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "Model.hpp"
+
+// Binary log of the boards and player actions of a session. After a 4-byte
+// magic, each record is an action byte, the milliseconds since the previous
+// record and a payload of LEB128 varints: the board parameters and seed for a
+// restart, zigzag deltas from the previous cell for cell actions, and the
+// byte size followed by the saved game for a load.
+enum class ReplayAction : std::uint8_t {
+  Restart,
+  Reveal,
+  Flag,
+  Chord,
+  Undo,
+  Redo,
+  Load
+};
+
+// Logs the operations of a model from its change notifications once a file
+// is open.
+class ReplayRecorder : public Model::Listener {
+public:
+  explicit ReplayRecorder(Model &model);
+  ReplayRecorder(const ReplayRecorder &) = delete;
+  ReplayRecorder &operator=(const ReplayRecorder &) = delete;
+  ~ReplayRecorder() override;
+
+  bool open(const std::string &path);
+  void onChanges(const Model::Changes &changes) override;
+
+private:
+  struct BoardKey {
+    int width;
+    int height;
+    int minesCount;
+    int generation;
+    std::uint64_t seed;
+  };
+
+  static BoardKey boardKey(const Model &model);
+  void record(ReplayAction action, int col, int row);
+  void recordLoad();
+  void writeRecord(ReplayAction action);
+
+  Model &m_model;
+  std::ofstream m_file;
+  std::chrono::steady_clock::time_point m_time;
+  BoardKey m_board;
+  bool m_hasBoard;
+  int m_col;
+  int m_row;
+};
+
+// Re-drives a model from a replay log without rendering, either as fast as
+// possible or at the pace the actions were recorded.
+class ReplayPlayer {
+public:
+  struct Summary {
+    long long restarts{0};
+    long long actions{0};
+    long long wins{0};
+    long long losses{0};
+    double modelSeconds{0.};
+    double wallSeconds{0.};
+    bool truncated{false};
+  };
+
+  explicit ReplayPlayer(Model &model);
+
+  bool open(const std::string &path);
+  Summary play(bool realTime);
+
+private:
+  void restart(int width, int height, int minesCount, int generation,
+               std::uint64_t seed);
+  void apply(ReplayAction action, int col, int row);
+  bool load();
+
+  Model &m_model;
+  std::ifstream m_file;
+};
+
+#endif
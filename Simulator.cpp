@@ -0,0 +1,187 @@
+#include "Simulator.hpp"
+#include "Model.hpp"
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr auto f_gamesPerTask{64};
+constexpr auto f_playerSeedSalt{0x9E3779B97F4A7C15ull};
+
+struct alignas(64) Worker {
+  Model model;
+  Solver solver{model};
+  std::mt19937_64 rng;
+  std::vector<int> order;
+  SimulationStats stats;
+};
+
+// Flags every certain mine and reveals every safe cell the solver finds, and
+// reveals a random hidden cell when it finds none.
+void playGame(Model &model, Solver &solver, std::vector<int> &order,
+              std::mt19937_64 &rng, SimulationStats &stats) {
+  auto &board{model.board()};
+  order.resize(static_cast<std::size_t>(board.size()));
+  std::iota(order.begin(), order.end(), 0);
+  std::shuffle(order.begin(), order.end(), rng);
+  auto nextGuess{order.begin()};
+  while (model.status() != Model::Status::Finished) {
+    solver.solve();
+    if (auto mine{solver.nextMineCell()}) {
+      while (board.cell(*mine).status() != Cell::Status::MarkedAsMine) {
+        model.cycleCellStatus(board.col(*mine), board.row(*mine));
+      }
+      model.update();
+      stats.clicks++;
+      continue;
+    }
+    auto index{solver.nextSafeCell()};
+    while (!index && nextGuess != order.end()) {
+      if (board.cell(*nextGuess).status() == Cell::Status::Hidden) {
+        index = *nextGuess;
+      }
+      nextGuess++;
+    }
+    if (!index) {
+      break;
+    }
+    model.reveal(board.col(*index), board.row(*index));
+    model.update();
+    stats.clicks++;
+  }
+  for (auto index = 0; index < board.size(); index++) {
+    auto cell{board.cell(index)};
+    if (cell.type() == Cell::Type::Empty &&
+        cell.status() == Cell::Status::Revealed) {
+      stats.revealedCells++;
+    }
+  }
+  stats.wins += model.success();
+}
+} // namespace
+
+void SimulationStats::add(const SimulationStats &other) {
+  if (other.games == 0) {
+    return;
+  }
+  minSeconds = games == 0 ? other.minSeconds
+                          : std::min(minSeconds, other.minSeconds);
+  maxSeconds = std::max(maxSeconds, other.maxSeconds);
+  games += other.games;
+  wins += other.wins;
+  clicks += other.clicks;
+  revealedCells += other.revealedCells;
+  seconds += other.seconds;
+}
+
+void SimulationStats::writeCsv(std::ostream &stream, int threads,
+                               double wallSeconds) const {
+  auto count{static_cast<double>(std::max(games, 1LL))};
+  stream << "games,wins,win_rate,clicks_per_game,revealed_per_game,"
+            "mean_game_ms,min_game_ms,max_game_ms,generation_p50_ms,"
+            "generation_p90_ms,generation_p99_ms,generation_max_ms,threads,"
+            "wall_s,games_per_s\n";
+  stream << games << ',' << wins << ',' << wins / count << ','
+         << clicks / count << ',' << revealedCells / count << ','
+         << seconds * 1e3 / count << ',' << minSeconds * 1e3 << ','
+         << maxSeconds * 1e3 << ',' << generationP50Ms << ','
+         << generationP90Ms << ',' << generationP99Ms << ','
+         << generationMaxMs << ',' << threads << ',' << wallSeconds << ','
+         << games / std::max(wallSeconds, 1e-9) << '\n';
+}
+
+void SimulationStats::writeJson(std::ostream &stream, int threads,
+                                double wallSeconds) const {
+  auto count{static_cast<double>(std::max(games, 1LL))};
+  stream << "{\n"
+         << "  \"games\": " << games << ",\n"
+         << "  \"wins\": " << wins << ",\n"
+         << "  \"win_rate\": " << wins / count << ",\n"
+         << "  \"clicks_per_game\": " << clicks / count << ",\n"
+         << "  \"revealed_per_game\": " << revealedCells / count << ",\n"
+         << "  \"mean_game_ms\": " << seconds * 1e3 / count << ",\n"
+         << "  \"min_game_ms\": " << minSeconds * 1e3 << ",\n"
+         << "  \"max_game_ms\": " << maxSeconds * 1e3 << ",\n"
+         << "  \"generation_p50_ms\": " << generationP50Ms << ",\n"
+         << "  \"generation_p90_ms\": " << generationP90Ms << ",\n"
+         << "  \"generation_p99_ms\": " << generationP99Ms << ",\n"
+         << "  \"generation_max_ms\": " << generationMaxMs << ",\n"
+         << "  \"threads\": " << threads << ",\n"
+         << "  \"wall_s\": " << wallSeconds << ",\n"
+         << "  \"games_per_s\": " << games / std::max(wallSeconds, 1e-9)
+         << "\n}\n";
+}
+
+Simulator::Simulator(const Options &options)
+    : m_options{options},
+      m_threads{options.threads > 0
+                    ? options.threads
+                    : static_cast<int>(std::thread::hardware_concurrency())},
+      m_wallSeconds{0.} {
+  m_threads = std::max(m_threads, 1);
+}
+
+int Simulator::threads() const { return m_threads; }
+
+double Simulator::wallSeconds() const { return m_wallSeconds; }
+
+SimulationStats Simulator::run() {
+  auto baseSeed{m_options.hasSeed ? m_options.seed
+                                  : std::random_device{}()};
+  std::vector<Worker> workers(static_cast<std::size_t>(m_threads));
+  for (auto &worker : workers) {
+    worker.model.generator().setThreads(1);
+    applyOptions(m_options, worker.model);
+    worker.model.generator().clearSamples();
+  }
+  auto start{std::chrono::steady_clock::now()};
+  {
+    ThreadPool pool{m_threads};
+    for (auto first = 0; first < m_options.games; first += f_gamesPerTask) {
+      auto last{std::min(first + f_gamesPerTask, m_options.games)};
+      pool.submit([&workers, baseSeed, first, last](int index) {
+        auto &worker{workers[index]};
+        for (auto game = first; game < last; game++) {
+          auto seed{baseSeed + static_cast<std::uint64_t>(game)};
+          auto gameStart{std::chrono::steady_clock::now()};
+          worker.model.restart(seed);
+          worker.rng.seed(seed ^ f_playerSeedSalt);
+          SimulationStats stats;
+          playGame(worker.model, worker.solver, worker.order, worker.rng,
+                   stats);
+          stats.games = 1;
+          stats.seconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - gameStart)
+                              .count();
+          stats.minSeconds = stats.seconds;
+          stats.maxSeconds = stats.seconds;
+          worker.stats.add(stats);
+        }
+      });
+    }
+    pool.wait();
+  }
+  m_wallSeconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  SimulationStats total;
+  std::vector<double> generationSamples;
+  for (auto &worker : workers) {
+    total.add(worker.stats);
+    auto &samples{worker.model.generator().samples()};
+    generationSamples.insert(generationSamples.end(), samples.begin(),
+                             samples.end());
+  }
+  total.generationP50Ms = NoGuessGenerator::percentile(generationSamples, .5);
+  total.generationP90Ms = NoGuessGenerator::percentile(generationSamples, .9);
+  total.generationP99Ms =
+      NoGuessGenerator::percentile(generationSamples, .99);
+  total.generationMaxMs = NoGuessGenerator::percentile(generationSamples, 1.);
+  return total;
+}
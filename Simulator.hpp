@@ -0,0 +1,45 @@
+#ifndef MINESWEEPER_SIMULATOR_HPP
+#define MINESWEEPER_SIMULATOR_HPP
+
+#include <cstdint>
+#include <ostream>
+
+#include "Options.hpp"
+
+struct SimulationStats {
+  long long games{0};
+  long long wins{0};
+  long long clicks{0};
+  long long revealedCells{0};
+  double seconds{0.};
+  double minSeconds{0.};
+  double maxSeconds{0.};
+  double generationP50Ms{0.};
+  double generationP90Ms{0.};
+  double generationP99Ms{0.};
+  double generationMaxMs{0.};
+
+  void add(const SimulationStats &other);
+  void writeCsv(std::ostream &stream, int threads, double wallSeconds) const;
+  void writeJson(std::ostream &stream, int threads, double wallSeconds) const;
+};
+
+// Plays independent games across a work-stealing thread pool. Every worker
+// owns its model, random generator and statistics, which are only merged once
+// all games are done.
+class Simulator {
+public:
+  explicit Simulator(const Options &options);
+
+  int threads() const;
+  double wallSeconds() const;
+
+  SimulationStats run();
+
+private:
+  Options m_options;
+  int m_threads;
+  double m_wallSeconds;
+};
+
+#endif
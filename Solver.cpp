@@ -0,0 +1,475 @@
+#include "Solver.hpp"
+
+#include <algorithm>
+#include <bitset>
+
+namespace {
+// Masks cover the 7x7 window around a centre cell, which holds the
+// neighbours of every cell within two steps of it.
+constexpr auto f_windowRadius{3};
+constexpr auto f_windowSide{2 * f_windowRadius + 1};
+constexpr auto f_maxSearchNodes{1 << 12};
+constexpr std::uint8_t f_safeOutcome{1};
+constexpr std::uint8_t f_mineOutcome{2};
+constexpr std::uint8_t f_bothOutcomes{f_safeOutcome | f_mineOutcome};
+
+inline int popcount(std::uint64_t mask) {
+  return static_cast<int>(std::bitset<64>{mask}.count());
+}
+
+template <typename Board, typename Visit>
+void forEachNeighbour(const Board &board, int index, Visit visit) {
+  auto col{board.col(index)};
+  auto row{board.row(index)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, board.height() - 1)};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      visit(board.index(i, j));
+    }
+  }
+}
+} // namespace
+
+Solver::Solver(Model &model)
+    : m_model{model}, m_knowledge{}, m_revealed{}, m_queued{},
+      m_dirtyCells{}, m_safeCells{}, m_mineCells{}, m_pendingCells{},
+      m_searched{}, m_searchedCells{}, m_slots{}, m_componentCells{},
+      m_constraints{}, m_links{}, m_linkStarts{}, m_choices{}, m_outcomes{},
+      m_componentMines{0}, m_mineBudget{0}, m_nextSafeCell{0},
+      m_nextMineCell{0}, m_unknownCount{0}, m_knownMinesCount{0} {
+  m_model.subscribe(this);
+}
+
+Solver::~Solver() { m_model.unsubscribe(this); }
+
+void Solver::reset() {
+  auto &board{m_model.board()};
+  auto size{static_cast<std::size_t>(board.size())};
+  m_knowledge.assign(size, Knowledge::Unknown);
+  m_revealed.assign(size, 0);
+  m_queued.assign(size, 0);
+  m_dirtyCells.clear();
+  m_safeCells.clear();
+  m_mineCells.clear();
+  m_pendingCells.clear();
+  m_searched.assign(size, 0);
+  m_searchedCells.clear();
+  m_nextSafeCell = 0;
+  m_nextMineCell = 0;
+  m_unknownCount = board.size();
+  m_knownMinesCount = 0;
+  for (auto index = 0; index < board.size(); index++) {
+    if (board.cell(index).status() == Cell::Status::Revealed &&
+        board.cell(index).type() == Cell::Type::Empty) {
+      addRevealedCell(index);
+    }
+  }
+}
+
+void Solver::onChanges(const Model::Changes &changes) {
+  if (changes.allCells || changes.change == Model::Change::Undo ||
+      changes.change == Model::Change::Redo ||
+      m_revealed.size() != static_cast<std::size_t>(m_model.board().size())) {
+    return reset();
+  }
+  auto &board{m_model.board()};
+  for (auto index : changes.cells) {
+    auto cell{board.cell(index)};
+    if (cell.status() == Cell::Status::Revealed &&
+        cell.type() == Cell::Type::Empty) {
+      addRevealedCell(index);
+    }
+  }
+}
+
+void Solver::solve() {
+  do {
+    while (!m_dirtyCells.empty()) {
+      auto index{m_dirtyCells.back()};
+      m_dirtyCells.pop_back();
+      m_queued[index] = 0;
+      examine(index);
+    }
+  } while (applyMinesCount() || searchFrontier());
+}
+
+std::optional<int> Solver::nextSafeCell() {
+  auto &board{m_model.board()};
+  while (m_nextSafeCell < m_safeCells.size()) {
+    auto index{m_safeCells[m_nextSafeCell++]};
+    if (board.cell(index).status() == Cell::Status::Hidden) {
+      return index;
+    }
+  }
+  return {};
+}
+
+std::optional<int> Solver::nextMineCell() {
+  auto &board{m_model.board()};
+  while (m_nextMineCell < m_mineCells.size()) {
+    auto index{m_mineCells[m_nextMineCell++]};
+    auto status{board.cell(index).status()};
+    if (status == Cell::Status::Hidden ||
+        status == Cell::Status::MarkedAsSuspect) {
+      return index;
+    }
+  }
+  return {};
+}
+
+void Solver::addRevealedCell(int index) {
+  if (m_revealed[index]) {
+    return;
+  }
+  m_revealed[index] = 1;
+  if (m_knowledge[index] == Knowledge::Unknown) {
+    m_knowledge[index] = Knowledge::Safe;
+    m_unknownCount--;
+  }
+  queueNeighbourhood(index);
+}
+
+void Solver::examine(int index) {
+  auto unknown{unknownMask(index, index)};
+  if (unknown == 0) {
+    return;
+  }
+  auto remaining{remainingMines(index)};
+  if (remaining == 0) {
+    return markCells(unknown, index, Knowledge::Safe);
+  }
+  if (remaining == popcount(unknown)) {
+    return markCells(unknown, index, Knowledge::Mine);
+  }
+  auto &board{m_model.board()};
+  auto col{board.col(index)};
+  auto row{board.row(index)};
+  auto firstCol{std::max(col - 2, 0)};
+  auto lastCol{std::min(col + 2, board.width() - 1)};
+  auto firstRow{std::max(row - 2, 0)};
+  auto lastRow{std::min(row + 2, board.height() - 1)};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      auto other{board.index(i, j)};
+      if (other == index || !m_revealed[other]) {
+        continue;
+      }
+      auto otherUnknown{unknownMask(other, index)};
+      if ((unknown & otherUnknown) == 0) {
+        continue;
+      }
+      auto otherRemaining{remainingMines(other)};
+      auto onlyUnknown{unknown & ~otherUnknown};
+      auto onlyOther{otherUnknown & ~unknown};
+      if ((onlyUnknown | onlyOther) == 0) {
+        continue;
+      }
+      if (otherRemaining - remaining == popcount(onlyOther)) {
+        markCells(onlyOther, index, Knowledge::Mine);
+        markCells(onlyUnknown, index, Knowledge::Safe);
+      } else if (remaining - otherRemaining == popcount(onlyUnknown)) {
+        markCells(onlyUnknown, index, Knowledge::Mine);
+        markCells(onlyOther, index, Knowledge::Safe);
+      } else {
+        continue;
+      }
+      queue(index);
+      return;
+    }
+  }
+  m_pendingCells.push_back(index);
+}
+
+void Solver::queue(int index) {
+  if (m_queued[index]) {
+    return;
+  }
+  m_queued[index] = 1;
+  m_dirtyCells.push_back(index);
+}
+
+void Solver::queueNeighbourhood(int index) {
+  auto &board{m_model.board()};
+  auto col{board.col(index)};
+  auto row{board.row(index)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, board.height() - 1)};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      auto neighbour{board.index(i, j)};
+      if (m_revealed[neighbour] &&
+          board.cell(neighbour).neighbourMinesCount() > 0) {
+        queue(neighbour);
+      }
+    }
+  }
+}
+
+void Solver::markCells(std::uint64_t mask, int centre, Knowledge knowledge) {
+  auto &board{m_model.board()};
+  auto col{board.col(centre)};
+  auto row{board.row(centre)};
+  for (auto bit = 0; mask != 0; bit++, mask >>= 1) {
+    if (mask & 1) {
+      setKnowledge(board.index(col + bit % f_windowSide - f_windowRadius,
+                               row + bit / f_windowSide - f_windowRadius),
+                   knowledge);
+    }
+  }
+}
+
+void Solver::setKnowledge(int index, Knowledge knowledge) {
+  if (m_knowledge[index] != Knowledge::Unknown) {
+    return;
+  }
+  m_knowledge[index] = knowledge;
+  m_unknownCount--;
+  if (knowledge == Knowledge::Mine) {
+    m_knownMinesCount++;
+    m_mineCells.push_back(index);
+  } else {
+    m_safeCells.push_back(index);
+  }
+  queueNeighbourhood(index);
+}
+
+bool Solver::applyMinesCount() {
+  auto remaining{m_model.totalMinesCount() - m_knownMinesCount};
+  if (m_unknownCount == 0 ||
+      (remaining != 0 && remaining != m_unknownCount)) {
+    return false;
+  }
+  auto knowledge{remaining == 0 ? Knowledge::Safe : Knowledge::Mine};
+  for (auto index = 0; index < m_model.board().size(); index++) {
+    setKnowledge(index, knowledge);
+  }
+  return true;
+}
+
+bool Solver::searchFrontier() {
+  auto progress{false};
+  for (auto index : m_pendingCells) {
+    if (!m_searched[index] && unknownMask(index, index) != 0) {
+      progress = searchComponent(index) || progress;
+    }
+  }
+  m_pendingCells.clear();
+  for (auto index : m_searchedCells) {
+    m_searched[index] = 0;
+  }
+  m_searchedCells.clear();
+  return progress;
+}
+
+bool Solver::searchComponent(int start) {
+  buildComponent(start);
+  enumerateComponent();
+  auto progress{false};
+  for (std::size_t position = 0; position < m_componentCells.size();
+       position++) {
+    auto outcome{m_outcomes[position]};
+    if (outcome == f_safeOutcome || outcome == f_mineOutcome) {
+      setKnowledge(m_componentCells[position], outcome == f_mineOutcome
+                                                   ? Knowledge::Mine
+                                                   : Knowledge::Safe);
+      progress = true;
+    }
+  }
+  return progress;
+}
+
+void Solver::buildComponent(int start) {
+  auto &board{m_model.board()};
+  m_slots.clear();
+  m_componentCells.clear();
+  m_constraints.clear();
+  auto addConstraint{[this](int index) {
+    m_searched[index] = 1;
+    m_searchedCells.push_back(index);
+    m_slots[index] = static_cast<int>(m_constraints.size());
+    m_constraints.push_back({remainingMines(index), 0, 0});
+  }};
+  auto first{m_searchedCells.size()};
+  addConstraint(start);
+  for (auto next = first; next < m_searchedCells.size(); next++) {
+    auto index{m_searchedCells[next]};
+    auto constraint{static_cast<std::size_t>(m_slots[index])};
+    forEachNeighbour(board, index, [&](int neighbour) {
+      if (m_knowledge[neighbour] != Knowledge::Unknown) {
+        return;
+      }
+      m_constraints[constraint].open++;
+      auto slot{static_cast<int>(m_componentCells.size())};
+      if (!m_slots.emplace(neighbour, slot).second) {
+        return;
+      }
+      m_componentCells.push_back(neighbour);
+      forEachNeighbour(board, neighbour, [&](int other) {
+        if (m_revealed[other] && !m_searched[other]) {
+          addConstraint(other);
+        }
+      });
+    });
+  }
+  m_links.clear();
+  m_linkStarts.clear();
+  for (auto index : m_componentCells) {
+    m_linkStarts.push_back(static_cast<int>(m_links.size()));
+    forEachNeighbour(board, index, [this](int neighbour) {
+      if (m_revealed[neighbour]) {
+        m_links.push_back(m_slots[neighbour]);
+      }
+    });
+  }
+  m_linkStarts.push_back(static_cast<int>(m_links.size()));
+}
+
+void Solver::enumerateComponent() {
+  auto size{m_componentCells.size()};
+  m_outcomes.assign(size, 0);
+  m_componentMines = 0;
+  m_mineBudget = m_model.totalMinesCount() - m_knownMinesCount;
+  auto nodes{0};
+  if (findAssignment(-1, false, nodes) != Search::Found) {
+    return m_outcomes.assign(size, f_bothOutcomes);
+  }
+  for (std::size_t position = 0; position < size; position++) {
+    auto outcome{m_outcomes[position]};
+    if (outcome == f_bothOutcomes) {
+      continue;
+    }
+    if (findAssignment(static_cast<int>(position), outcome == f_safeOutcome,
+                       nodes) == Search::Aborted) {
+      m_outcomes[position] = f_bothOutcomes;
+    }
+  }
+}
+
+Solver::Search Solver::findAssignment(int forced, bool mine, int &nodes) {
+  auto count{static_cast<int>(m_componentCells.size())};
+  m_choices.assign(static_cast<std::size_t>(count), 0);
+  auto skip{[forced](int position, int step) {
+    return position == forced ? position + step : position;
+  }};
+  auto search{Search::Exhausted};
+  auto position{skip(0, 1)};
+  if (forced >= 0) {
+    m_choices[static_cast<std::size_t>(forced)] = mine ? 2 : 1;
+    if (!assign(forced, mine)) {
+      position = -1;
+    }
+  }
+  while (position >= 0) {
+    if (position == count) {
+      for (std::size_t i = 0; i < m_choices.size(); i++) {
+        m_outcomes[i] |= m_choices[i] == 2 ? f_mineOutcome : f_safeOutcome;
+      }
+      search = Search::Found;
+      break;
+    }
+    auto &choice{m_choices[static_cast<std::size_t>(position)]};
+    if (choice != 0) {
+      unassign(position, choice == 2);
+    }
+    if (choice == 2) {
+      choice = 0;
+      position = skip(position - 1, -1);
+      continue;
+    }
+    if (++nodes > f_maxSearchNodes) {
+      search = Search::Aborted;
+      break;
+    }
+    choice++;
+    if (assign(position, choice == 2)) {
+      position = skip(position + 1, 1);
+    }
+  }
+  for (auto i = 0; i < count; i++) {
+    auto choice{m_choices[static_cast<std::size_t>(i)]};
+    if (choice != 0) {
+      unassign(i, choice == 2);
+    }
+  }
+  return search;
+}
+
+bool Solver::assign(int position, bool mine) {
+  auto valid{true};
+  if (mine) {
+    m_componentMines++;
+    valid = m_componentMines <= m_mineBudget;
+  }
+  for (auto link = m_linkStarts[position]; link < m_linkStarts[position + 1];
+       link++) {
+    auto &constraint{m_constraints[static_cast<std::size_t>(m_links[link])]};
+    constraint.open--;
+    if (mine) {
+      constraint.mines++;
+    }
+    valid = valid && constraint.mines <= constraint.remaining &&
+            constraint.mines + constraint.open >= constraint.remaining;
+  }
+  return valid;
+}
+
+void Solver::unassign(int position, bool mine) {
+  if (mine) {
+    m_componentMines--;
+  }
+  for (auto link = m_linkStarts[position]; link < m_linkStarts[position + 1];
+       link++) {
+    auto &constraint{m_constraints[static_cast<std::size_t>(m_links[link])]};
+    constraint.open++;
+    if (mine) {
+      constraint.mines--;
+    }
+  }
+}
+
+std::uint64_t Solver::unknownMask(int index, int centre) const {
+  auto &board{m_model.board()};
+  auto col{board.col(index)};
+  auto row{board.row(index)};
+  auto centreCol{board.col(centre)};
+  auto centreRow{board.row(centre)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, board.height() - 1)};
+  std::uint64_t mask{0};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      if (m_knowledge[board.index(i, j)] == Knowledge::Unknown) {
+        auto bit{(i - centreCol + f_windowRadius) +
+                 (j - centreRow + f_windowRadius) * f_windowSide};
+        mask |= std::uint64_t{1} << bit;
+      }
+    }
+  }
+  return mask;
+}
+
+int Solver::remainingMines(int index) const {
+  auto &board{m_model.board()};
+  auto col{board.col(index)};
+  auto row{board.row(index)};
+  auto firstCol{std::max(col - 1, 0)};
+  auto lastCol{std::min(col + 1, board.width() - 1)};
+  auto firstRow{std::max(row - 1, 0)};
+  auto lastRow{std::min(row + 1, board.height() - 1)};
+  auto remaining{board.cell(index).neighbourMinesCount()};
+  for (auto j = firstRow; j <= lastRow; j++) {
+    for (auto i = firstCol; i <= lastCol; i++) {
+      if (m_knowledge[board.index(i, j)] == Knowledge::Mine) {
+        remaining--;
+      }
+    }
+  }
+  return remaining;
+}
@@ -0,0 +1,85 @@
+#ifndef MINESWEEPER_SOLVER_HPP
+#define MINESWEEPER_SOLVER_HPP
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "Model.hpp"
+
+// Deduces safe cells and certain mines from the numbers revealed in a Model.
+// Only the constraints around newly revealed or newly deduced cells are
+// re-examined, so the cost of each update follows the size of the change.
+// When the single-cell and subset rules stall, every frontier component touched
+// since the last stall is solved by enumerating its consistent assignments,
+// within a fixed search budget per component. Player flags are not trusted and
+// do not take part in the deductions. The solver follows the model through its
+// change notifications.
+class Solver : public Model::Listener {
+public:
+  explicit Solver(Model &model);
+  Solver(const Solver &) = delete;
+  Solver &operator=(const Solver &) = delete;
+  ~Solver() override;
+
+  void reset();
+  void onChanges(const Model::Changes &changes) override;
+  void solve();
+
+  std::optional<int> nextSafeCell();
+  std::optional<int> nextMineCell();
+
+private:
+  enum class Knowledge : std::uint8_t { Unknown, Safe, Mine };
+  enum class Search { Found, Exhausted, Aborted };
+
+  struct Constraint {
+    int remaining;
+    int mines;
+    int open;
+  };
+
+  void addRevealedCell(int index);
+  void examine(int index);
+  void queue(int index);
+  void queueNeighbourhood(int index);
+  void markCells(std::uint64_t mask, int centre, Knowledge knowledge);
+  void setKnowledge(int index, Knowledge knowledge);
+  bool applyMinesCount();
+  bool searchFrontier();
+  bool searchComponent(int start);
+  void buildComponent(int start);
+  void enumerateComponent();
+  Search findAssignment(int forced, bool mine, int &nodes);
+  bool assign(int position, bool mine);
+  void unassign(int position, bool mine);
+  std::uint64_t unknownMask(int index, int centre) const;
+  int remainingMines(int index) const;
+
+  Model &m_model;
+  std::vector<Knowledge> m_knowledge;
+  std::vector<std::uint8_t> m_revealed;
+  std::vector<std::uint8_t> m_queued;
+  std::vector<int> m_dirtyCells;
+  std::vector<int> m_safeCells;
+  std::vector<int> m_mineCells;
+  std::vector<int> m_pendingCells;
+  std::vector<std::uint8_t> m_searched;
+  std::vector<int> m_searchedCells;
+  std::unordered_map<int, int> m_slots;
+  std::vector<int> m_componentCells;
+  std::vector<Constraint> m_constraints;
+  std::vector<int> m_links;
+  std::vector<int> m_linkStarts;
+  std::vector<std::uint8_t> m_choices;
+  std::vector<std::uint8_t> m_outcomes;
+  int m_componentMines;
+  int m_mineBudget;
+  std::size_t m_nextSafeCell;
+  std::size_t m_nextMineCell;
+  int m_unknownCount;
+  int m_knownMinesCount;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "TextureAtlas.hpp"
+
+#include <SFML/Graphics/Image.hpp>
+#include <algorithm>
+
+namespace {
+constexpr auto f_maxWidth{1024u};
+constexpr auto f_padding{2u};
+constexpr auto f_whiteSize{4u};
+} // namespace
+
+TextureAtlas::TextureAtlas() : m_texture{}, m_rects{}, m_whiteRect{} {}
+
+const sf::Texture &TextureAtlas::texture() const { return m_texture; }
+
+const sf::IntRect &TextureAtlas::rect(std::size_t index) const {
+  return m_rects[index];
+}
+
+const sf::IntRect &TextureAtlas::whiteRect() const { return m_whiteRect; }
+
+void TextureAtlas::loadFromFiles(const std::vector<const char *> &paths) {
+  std::vector<sf::Image> images(paths.size());
+  m_rects.assign(paths.size(), {});
+  auto x{f_padding};
+  auto y{f_padding};
+  auto rowHeight{0u};
+  auto width{0u};
+  auto place = [&](unsigned w, unsigned h) {
+    if (x + w + f_padding > f_maxWidth && x > f_padding) {
+      x = f_padding;
+      y += rowHeight + f_padding;
+      rowHeight = 0;
+    }
+    sf::IntRect rect{static_cast<int>(x), static_cast<int>(y),
+                     static_cast<int>(w), static_cast<int>(h)};
+    x += w + f_padding;
+    rowHeight = std::max(rowHeight, h);
+    width = std::max(width, x);
+    return rect;
+  };
+  for (std::size_t i = 0; i < paths.size(); i++) {
+    images[i].loadFromFile(paths[i]);
+    auto size{images[i].getSize()};
+    m_rects[i] = place(size.x, size.y);
+  }
+  auto white{place(f_whiteSize, f_whiteSize)};
+  sf::Image atlas;
+  atlas.create(width, y + rowHeight + f_padding, sf::Color::Transparent);
+  for (std::size_t i = 0; i < images.size(); i++) {
+    atlas.copy(images[i], static_cast<unsigned>(m_rects[i].left),
+               static_cast<unsigned>(m_rects[i].top));
+  }
+  for (auto i = 0u; i < f_whiteSize * f_whiteSize; i++) {
+    atlas.setPixel(static_cast<unsigned>(white.left) + i % f_whiteSize,
+                   static_cast<unsigned>(white.top) + i / f_whiteSize,
+                   sf::Color::White);
+  }
+  m_whiteRect = {white.left + 1, white.top + 1, white.width - 2,
+                 white.height - 2};
+  m_texture.loadFromImage(atlas);
+  m_texture.setSmooth(true);
+}
@@ -0,0 +1,26 @@
+#ifndef MINESWEEPER_TEXTURE_ATLAS_HPP
+#define MINESWEEPER_TEXTURE_ATLAS_HPP
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <vector>
+
+// Images packed into rows of a single texture, looked up by load order. A
+// white block is appended for untextured quads drawn in the same batch.
+class TextureAtlas {
+public:
+  TextureAtlas();
+
+  const sf::Texture &texture() const;
+  const sf::IntRect &rect(std::size_t index) const;
+  const sf::IntRect &whiteRect() const;
+
+  void loadFromFiles(const std::vector<const char *> &paths);
+
+private:
+  sf::Texture m_texture;
+  std::vector<sf::IntRect> m_rects;
+  sf::IntRect m_whiteRect;
+};
+
+#endif
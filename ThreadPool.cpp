@@ -0,0 +1,95 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadsCount)
+    : m_queues{}, m_threads{}, m_queuedTasks{0}, m_pendingTasks{0},
+      m_nextQueue{0}, m_stopping{false}, m_mutex{}, m_taskAvailable{},
+      m_tasksDone{} {
+  threadsCount = std::max(threadsCount, 1);
+  for (auto i = 0; i < threadsCount; i++) {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+  for (auto i = 0; i < threadsCount; i++) {
+    m_threads.emplace_back([this, i] { run(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_stopping = true;
+  }
+  m_taskAvailable.notify_all();
+  for (auto &thread : m_threads) {
+    thread.join();
+  }
+}
+
+int ThreadPool::size() const { return static_cast<int>(m_threads.size()); }
+
+void ThreadPool::submit(Task task) {
+  auto &queue{*m_queues[m_nextQueue++ % m_queues.size()]};
+  m_pendingTasks++;
+  {
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_queuedTasks++;
+  }
+  m_taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock{m_mutex};
+  m_tasksDone.wait(lock, [this] { return m_pendingTasks == 0; });
+}
+
+void ThreadPool::run(int worker) {
+  Task task;
+  while (true) {
+    if (pop(worker, task) || steal(worker, task)) {
+      m_queuedTasks--;
+      task(worker);
+      task = nullptr;
+      if (--m_pendingTasks == 0) {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_tasksDone.notify_all();
+      }
+      continue;
+    }
+    std::unique_lock<std::mutex> lock{m_mutex};
+    m_taskAvailable.wait(lock,
+                         [this] { return m_stopping || m_queuedTasks > 0; });
+    if (m_stopping && m_queuedTasks == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::pop(int worker, Task &task) {
+  auto &queue{*m_queues[worker]};
+  std::lock_guard<std::mutex> lock{queue.mutex};
+  if (queue.tasks.empty()) {
+    return false;
+  }
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool ThreadPool::steal(int worker, Task &task) {
+  auto queuesCount{static_cast<int>(m_queues.size())};
+  for (auto i = 1; i < queuesCount; i++) {
+    auto &queue{*m_queues[(worker + i) % queuesCount]};
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (!queue.tasks.empty()) {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,48 @@
+#ifndef MINESWEEPER_THREAD_POOL_HPP
+#define MINESWEEPER_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing pool: each worker runs tasks from the back of its own queue
+// and steals from the front of the other queues when it runs out.
+class ThreadPool {
+public:
+  using Task = std::function<void(int worker)>;
+
+  explicit ThreadPool(int threadsCount);
+  ~ThreadPool();
+
+  int size() const;
+
+  void submit(Task task);
+  void wait();
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void run(int worker);
+  bool pop(int worker, Task &task);
+  bool steal(int worker, Task &task);
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::atomic<int> m_queuedTasks;
+  std::atomic<int> m_pendingTasks;
+  std::atomic<unsigned> m_nextQueue;
+  bool m_stopping;
+  std::mutex m_mutex;
+  std::condition_variable m_taskAvailable;
+  std::condition_variable m_tasksDone;
+};
+
+#endif
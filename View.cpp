@@ -1,7 +1,9 @@
 #include "View.hpp"
 #include <SFML/Window/Mouse.hpp>
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 
 namespace {
 constexpr auto f_fontPath{"../resources/futura.ttf"};
@@ -28,10 +30,18 @@ constexpr auto f_happyIconPath{"../resources/happy.png"};
 constexpr auto f_sadIconPath{"../resources/sad.png"};
 constexpr auto f_quitIconPath{"../resources/quit.png"};
 constexpr auto f_fontSize{25};
+constexpr auto f_profilerFontSize{16};
+constexpr auto f_profilerMargin{10.f};
+constexpr std::size_t f_profilerRefreshFrames{30};
+constexpr std::size_t f_profilerTextCapacity{512};
 constexpr auto f_zoomMaxLevel{1.f};
 constexpr auto f_zoomMinLevel{2.f};
 constexpr auto f_zoomSensibility{0.1f};
 constexpr auto f_zoomDefaultLevel{f_zoomMinLevel};
+constexpr auto f_panStep{4 * 63.5f};
+constexpr auto f_lodCellSize{8.f};
+constexpr auto f_lodMaxTextureSide{2048u};
+constexpr auto f_changedCellsFraction{4};
 constexpr auto f_buttonSmallWidth{63.5f};
 constexpr auto f_buttonMediumWidth{2 * f_buttonSmallWidth};
 constexpr auto f_buttonBigWidth{3 * f_buttonSmallWidth};
@@ -41,8 +51,19 @@ constexpr auto f_defaultWindowWidth{1920};
 constexpr auto f_defaultWindowHeight{1080};
 constexpr auto f_menuFrameHeight{64.f};
 constexpr auto f_menuButtonTextVOffset{5.f};
+constexpr auto f_boardMaxWidth{30 * f_buttonSmallWidth};
+constexpr auto f_boardMaxHeight{16 * f_buttonHeight};
 constexpr auto f_menuLeftMargin{
     (f_defaultWindowWidth - 30 * f_buttonSmallWidth) * .5f};
+constexpr auto f_sizeButtonCol{0};
+constexpr auto f_sizeButtonWidth{3};
+constexpr auto f_restartButtonCol{14};
+constexpr auto f_restartButtonWidth{2};
+constexpr auto f_quitButtonCol{29};
+constexpr auto f_quitButtonWidth{1};
+constexpr auto f_minesDisplayCol{11};
+constexpr auto f_timeDisplayCol{16};
+constexpr auto f_displayWidth{3};
 constexpr auto f_buttonOutlineThickness{1.f};
 constexpr auto f_displayOutlineThickness{10.f};
 const auto f_fontColor{sf::Color::White};
@@ -51,214 +72,561 @@ const auto f_buttonPressedColor{sf::Color{56, 64, 72}};
 const auto f_buttonHighlightedColor{sf::Color{200, 200, 200}};
 const auto f_cellMineTriggeredColor{sf::Color{139, 0, 0}};
 const auto f_cellFalseFlagColor{sf::Color{136, 51, 51}};
-const auto f_menuFrameColor{sf::Color{68, 76, 84}};
 const auto f_menuButtonColor{sf::Color{120, 128, 136}};
 const auto f_menuHighlightedButtonColor{sf::Color{200, 200, 200}};
 const auto f_menuDisplayColor{sf::Color::Black};
 const auto f_buttonOutlineColor{sf::Color::Transparent};
 const auto f_backgroundColor{sf::Color{40, 40, 40}};
+const auto f_profilerBackgroundColor{sf::Color{0, 0, 0, 192}};
+// Level of detail colours by increasing priority: a block takes the colour of
+// its highest priority cell.
+const sf::Color f_lodColors[]{
+    f_buttonPressedColor,
+    sf::Color{88, 96, 104},
+    f_buttonColor,
+    sf::Color{200, 170, 60},
+    sf::Color{200, 60, 60},
+    sf::Color::Black,
+    f_cellMineTriggeredColor,
+};
 
-inline std::string formattedTime(int seconds) {
-  std::stringstream ss;
-  auto min{seconds / 60};
-  auto sec{seconds % 60};
-  ss << std::setw(2) << std::setfill('0') << min;
-  ss << ":";
-  ss << std::setw(2) << sec;
-  return ss.str();
+inline int lodPriority(Cell cell) {
+  switch (cell.status()) {
+  case Cell::Status::Revealed:
+    if (cell.triggered()) {
+      return 6;
+    }
+    if (cell.type() == Cell::Type::Mine) {
+      return 5;
+    }
+    return cell.neighbourMinesCount() > 0 ? 1 : 0;
+  case Cell::Status::MarkedAsMine:
+    return 4;
+  case Cell::Status::MarkedAsSuspect:
+    return 3;
+  default:
+    return 2;
+  }
 }
+
 } // namespace
 
 View::View(sf::RenderWindow &window, Model &model)
-    : m_model{model}, m_window{window}, m_font{},
-      m_icons{{ButtonIcon::Mine, {}},
-              {ButtonIcon::Flag, {}},
-              {ButtonIcon::QuestionMark, {}}},
-      m_buttonUnderMouse{}, m_cellUnderMouse{}, m_zoomLevel{
-                                                    f_zoomDefaultLevel} {
+    : View{window, &window, nullptr, model} {}
+
+View::View(sf::RenderTexture &texture, Model &model)
+    : View{texture, nullptr, &texture, model} {}
+
+View::View(sf::RenderTarget &target, sf::RenderWindow *window,
+           sf::RenderTexture *texture, Model &model)
+    : m_model{model}, m_target{target}, m_window{window}, m_texture{texture},
+      m_font{}, m_atlas{}, m_zoomLevel{f_zoomDefaultLevel},
+      m_cellBackgrounds{}, m_cellIcons{}, m_cellLooks{}, m_backgroundSlots{},
+      m_iconSlots{}, m_meshBoardSize{}, m_meshCellSize{}, m_menuQuads{},
+      m_sizeLabel{}, m_minesLabel{}, m_timeLabel{}, m_hover{},
+      m_drawnRevision{0}, m_invalid{true}, m_camera{}, m_meshCells{},
+      m_profiler{nullptr}, m_profilerRecording{false},
+      m_profilerVisible{false},
+      m_profilerRefreshFrame{0}, m_profilerText{}, m_profilerQuads{},
+      m_changedCells{}, m_allCellsChanged{true}, m_statusChanged{true},
+      m_meshHover{}, m_lodPixels{}, m_lodTexture{}, m_lodQuad{},
+      m_lodBoardSize{}, m_lodSize{}, m_lodBlock{1}, m_lodDirtyTop{0},
+      m_lodDirtyBottom{0}, m_lodStale{true} {
+  m_model.subscribe(this);
   loadResources();
+  m_profilerText.setFont(m_font);
+  m_profilerText.setCharacterSize(f_profilerFontSize);
+  m_profilerText.setFillColor(f_fontColor);
+  m_profilerText.setPosition(f_profilerMargin,
+                             f_buttonHeight + f_profilerMargin);
+  initLabel(m_sizeLabel, menuRect(f_sizeButtonCol, f_sizeButtonWidth,
+                                  f_buttonOutlineThickness));
+  initLabel(m_minesLabel, menuRect(f_minesDisplayCol, f_displayWidth,
+                                   f_displayOutlineThickness));
+  initLabel(m_timeLabel, menuRect(f_timeDisplayCol, f_displayWidth,
+                                  f_displayOutlineThickness));
+}
+
+View::~View() { m_model.unsubscribe(this); }
+
+View::Button View::buttonAtPixel(const sf::Vector2i &pixel) const {
+  return buttonAt(m_target.mapPixelToCoords(pixel));
+}
+
+std::optional<std::pair<int, int>>
+View::cellAtPixel(const sf::Vector2i &pixel) const {
+  return cellAt(m_target.mapPixelToCoords(pixel));
 }
 
-View::Button View::buttonUnderMouse() const { return m_buttonUnderMouse; }
+bool View::needsUpdate() const {
+  return m_invalid || m_model.revision() != m_drawnRevision ||
+         !(hover() == m_hover);
+}
 
-std::optional<std::pair<int, int>> View::cellUnderMouse() const {
-  return m_cellUnderMouse;
+void View::onChanges(const Model::Changes &changes) {
+  if (changes.status != changes.previousStatus) {
+    m_statusChanged = true;
+  }
+  if (m_allCellsChanged) {
+    return;
+  }
+  auto limit{static_cast<std::size_t>(m_model.board().size() /
+                                      f_changedCellsFraction)};
+  if (changes.allCells ||
+      m_changedCells.size() + changes.cells.size() > limit) {
+    m_allCellsChanged = true;
+    m_changedCells.clear();
+    return;
+  }
+  m_changedCells.insert(m_changedCells.end(), changes.cells.begin(),
+                        changes.cells.end());
 }
 
 void View::update() {
-  m_window.clear();
-  m_buttonUnderMouse = Button::None;
-  m_cellUnderMouse.reset();
-  drawBackground();
-  drawCells();
-  drawMenu();
-  scaleWindow();
-  m_window.display();
+  clampCamera();
+  m_hover = hover();
+  m_drawnRevision = m_model.revision();
+  m_invalid = false;
+  runStage(FrameProfiler::Stage::Background, &View::drawBackground);
+  runStage(FrameProfiler::Stage::Cells, &View::drawCells);
+  runStage(FrameProfiler::Stage::Menu, &View::drawMenu);
+  drawProfiler();
+  runStage(FrameProfiler::Stage::ScaleWindow, &View::scaleWindow);
+  runStage(FrameProfiler::Stage::Display, &View::display);
+}
+
+FrameProfiler *View::activeProfiler() const {
+  return m_profilerRecording || m_profilerVisible ? m_profiler : nullptr;
+}
+
+void View::setProfiler(FrameProfiler *profiler, bool recording) {
+  m_profiler = profiler;
+  m_profilerRecording = recording;
 }
 
+void View::toggleProfiler() {
+  m_profilerVisible = !m_profilerVisible;
+  m_profilerRefreshFrame = 0;
+  invalidate();
+}
+
+void View::invalidate() { m_invalid = true; }
+
 void View::zoomIn() {
-  m_zoomLevel = std::min(m_zoomLevel + f_zoomSensibility, f_zoomMinLevel);
+  setZoomLevel(std::min(m_zoomLevel * (1.f + f_zoomSensibility),
+                        f_zoomMinLevel / boardScale()));
 }
 
 void View::zoomOut() {
-  m_zoomLevel = std::max(m_zoomLevel - f_zoomSensibility, f_zoomMaxLevel);
+  setZoomLevel(
+      std::max(m_zoomLevel / (1.f + f_zoomSensibility), f_zoomMaxLevel));
+}
+
+void View::pan(const sf::Vector2f &offset) {
+  m_camera += offset;
+  clampCamera();
+  invalidate();
+}
+
+void View::pan(Direction direction) {
+  switch (direction) {
+  case Direction::Left:
+    return pan({-f_panStep, 0.f});
+  case Direction::Right:
+    return pan({f_panStep, 0.f});
+  case Direction::Up:
+    return pan({0.f, -f_panStep});
+  case Direction::Down:
+    return pan({0.f, f_panStep});
+  }
 }
 
-void View::closeWindow() { m_window.close(); }
+void View::drag(const sf::Vector2i &from, const sf::Vector2i &to) {
+  pan(m_target.mapPixelToCoords(from) - m_target.mapPixelToCoords(to));
+}
+
+void View::closeWindow() {
+  if (m_window) {
+    m_window->close();
+  }
+}
 
 void View::loadResources() {
   m_font.loadFromFile(f_fontPath);
-  m_icons[ButtonIcon::ButtonStandard].loadFromFile(f_smallButtonIconPath);
-  m_icons[ButtonIcon::Button11Middle].loadFromFile(f_button11MiddleIconPath);
-  m_icons[ButtonIcon::Button13Middle].loadFromFile(f_button13MiddleIconPath);
-  m_icons[ButtonIcon::Button2Middle].loadFromFile(f_button2MiddleIconPath);
-  m_icons[ButtonIcon::Button1Right].loadFromFile(f_button1RightIconPath);
-  m_icons[ButtonIcon::Button3Left].loadFromFile(f_button3LeftIconPath);
-  m_icons[ButtonIcon::One].loadFromFile(f_1IconPath);
-  m_icons[ButtonIcon::Two].loadFromFile(f_2IconPath);
-  m_icons[ButtonIcon::Three].loadFromFile(f_3IconPath);
-  m_icons[ButtonIcon::Four].loadFromFile(f_4IconPath);
-  m_icons[ButtonIcon::Five].loadFromFile(f_5IconPath);
-  m_icons[ButtonIcon::Six].loadFromFile(f_6IconPath);
-  m_icons[ButtonIcon::Seven].loadFromFile(f_7IconPath);
-  m_icons[ButtonIcon::Eight].loadFromFile(f_8IconPath);
-  m_icons[ButtonIcon::Mine].loadFromFile(f_mineIconPath);
-  m_icons[ButtonIcon::Flag].loadFromFile(f_flagIconPath);
-  m_icons[ButtonIcon::QuestionMark].loadFromFile(f_questionMarkIconPath);
-  m_icons[ButtonIcon::Happy].loadFromFile(f_happyIconPath);
-  m_icons[ButtonIcon::Sad].loadFromFile(f_sadIconPath);
-  m_icons[ButtonIcon::Quit].loadFromFile(f_quitIconPath);
-  for (auto &icon : m_icons) {
-    icon.second.setSmooth(true);
-  }
-}
-
-void View::drawBackground() {
-  ButtonArea background{{static_cast<float>(f_defaultWindowWidth),
-                         static_cast<float>(f_defaultWindowHeight)}};
-  background.setFillColor(f_backgroundColor);
-  m_window.draw(background);
+  m_atlas.loadFromFiles({f_smallButtonIconPath,
+                         f_button11MiddleIconPath,
+                         f_button13MiddleIconPath,
+                         f_button2MiddleIconPath,
+                         f_button3LeftIconPath,
+                         f_button1RightIconPath,
+                         f_1IconPath,
+                         f_2IconPath,
+                         f_3IconPath,
+                         f_4IconPath,
+                         f_5IconPath,
+                         f_6IconPath,
+                         f_7IconPath,
+                         f_8IconPath,
+                         f_mineIconPath,
+                         f_flagIconPath,
+                         f_questionMarkIconPath,
+                         f_happyIconPath,
+                         f_sadIconPath,
+                         f_quitIconPath});
 }
 
+void View::drawBackground() { m_target.clear(f_backgroundColor); }
+
 void View::drawCells() {
-  for (decltype(m_model.height()) row = 0; row < m_model.height(); row++) {
-    for (decltype(m_model.width()) col = 0; col < m_model.width(); col++) {
-      drawCellButton(col, row);
+  updateLevelOfDetail();
+  auto allCells{m_allCellsChanged || m_statusChanged};
+  m_allCellsChanged = false;
+  m_statusChanged = false;
+  if (cellButtonSize().x < f_lodCellSize) {
+    m_changedCells.clear();
+    m_meshCellSize = {};
+    return drawLevelOfDetail();
+  }
+  auto mouseStatus{m_hover.pressed ? ButtonStatus::Pressed
+                                   : ButtonStatus::Highlighted};
+  auto visible{visibleCells()};
+  sf::Vector2i boardSize{m_model.width(), m_model.height()};
+  auto rebuild{m_meshCells != visible || m_meshBoardSize != boardSize ||
+               m_meshCellSize != cellButtonSize()};
+  if (rebuild) {
+    auto count{static_cast<std::size_t>(visible.width * visible.height)};
+    m_cellBackgrounds.clear();
+    m_cellIcons.clear();
+    m_cellLooks.assign(count, {});
+    m_backgroundSlots.assign(count, -1);
+    m_iconSlots.assign(count, -1);
+    m_meshCells = visible;
+    m_meshBoardSize = boardSize;
+    m_meshCellSize = cellButtonSize();
+  }
+  if (rebuild || allCells) {
+    for (auto row = visible.top; row < visible.top + visible.height; row++) {
+      for (auto col = visible.left; col < visible.left + visible.width;
+           col++) {
+        updateCell(col, row, mouseStatus, rebuild);
+      }
+    }
+  } else {
+    auto &board{m_model.board()};
+    for (auto index : m_changedCells) {
+      updateCell(board.col(index), board.row(index), mouseStatus, false);
+    }
+    if (m_meshHover.cell) {
+      updateCell(m_meshHover.cell->first, m_meshHover.cell->second,
+                 mouseStatus, false);
+    }
+    if (m_hover.cell) {
+      updateCell(m_hover.cell->first, m_hover.cell->second, mouseStatus,
+                 false);
+    }
+  }
+  m_changedCells.clear();
+  m_meshHover = m_hover;
+  auto view{m_target.getView()};
+  m_target.setView(boardView());
+  m_cellBackgrounds.draw(m_target, &m_atlas.texture());
+  m_cellIcons.draw(m_target, &m_atlas.texture());
+  m_target.setView(view);
+}
+
+void View::updateCell(int col, int row, ButtonStatus mouseStatus,
+                      bool force) {
+  if (!m_meshCells.contains(col, row)) {
+    return;
+  }
+  auto index{(row - m_meshCells.top) * m_meshCells.width + col -
+             m_meshCells.left};
+  auto hovered{m_hover.cell && *m_hover.cell == std::pair<int, int>{col, row}};
+  auto look{cellLook(col, row, hovered ? mouseStatus : ButtonStatus::Released)};
+  if (force || !(look == m_cellLooks[index])) {
+    updateCellQuads(index, cellButtonPosition(col, row), look);
+  }
+}
+
+void View::drawLevelOfDetail() {
+  if (m_lodStale) {
+    rebuildLevelOfDetail();
+  }
+  if (m_lodDirtyTop < m_lodDirtyBottom) {
+    auto width{static_cast<std::size_t>(m_lodSize.x)};
+    m_lodTexture.update(m_lodPixels.data() + m_lodDirtyTop * width * 4,
+                        static_cast<unsigned>(m_lodSize.x),
+                        static_cast<unsigned>(m_lodDirtyBottom - m_lodDirtyTop),
+                        0, static_cast<unsigned>(m_lodDirtyTop));
+    m_lodDirtyTop = m_lodSize.y;
+    m_lodDirtyBottom = 0;
+  }
+  auto size{cellButtonSize()};
+  auto block{static_cast<float>(m_lodBlock)};
+  auto width{static_cast<float>(m_model.width())};
+  auto height{static_cast<float>(m_model.height())};
+  sf::FloatRect area{cellButtonPosition(0, 0),
+                     {size.x * width, size.y * height}};
+  m_lodQuad.setQuad(0, area, sf::Color::White,
+                    {0.f, 0.f, width / block, height / block});
+  auto view{m_target.getView()};
+  m_target.setView(boardView());
+  m_lodQuad.draw(m_target, &m_lodTexture);
+  m_target.setView(view);
+}
+
+void View::updateLevelOfDetail() {
+  if (m_allCellsChanged ||
+      m_lodBoardSize != sf::Vector2i{m_model.width(), m_model.height()}) {
+    m_lodStale = true;
+  }
+  if (m_lodStale) {
+    return;
+  }
+  auto &board{m_model.board()};
+  for (auto index : m_changedCells) {
+    updateLevelOfDetailBlock(board.col(index) / m_lodBlock,
+                             board.row(index) / m_lodBlock);
+  }
+}
+
+void View::rebuildLevelOfDetail() {
+  m_lodBoardSize = {m_model.width(), m_model.height()};
+  auto maxSide{std::min(f_lodMaxTextureSide, sf::Texture::getMaximumSize())};
+  m_lodBlock = 1;
+  while ((m_lodBoardSize.x + m_lodBlock - 1) / m_lodBlock >
+             static_cast<int>(maxSide) ||
+         (m_lodBoardSize.y + m_lodBlock - 1) / m_lodBlock >
+             static_cast<int>(maxSide)) {
+    m_lodBlock *= 2;
+  }
+  m_lodSize = {(m_lodBoardSize.x + m_lodBlock - 1) / m_lodBlock,
+               (m_lodBoardSize.y + m_lodBlock - 1) / m_lodBlock};
+  m_lodPixels.assign(static_cast<std::size_t>(m_lodSize.x) * m_lodSize.y * 4,
+                     0);
+  if (m_lodTexture.getSize() !=
+      sf::Vector2u{static_cast<unsigned>(m_lodSize.x),
+                   static_cast<unsigned>(m_lodSize.y)}) {
+    m_lodTexture.create(static_cast<unsigned>(m_lodSize.x),
+                        static_cast<unsigned>(m_lodSize.y));
+  }
+  for (auto row = 0; row < m_lodSize.y; row++) {
+    for (auto col = 0; col < m_lodSize.x; col++) {
+      updateLevelOfDetailBlock(col, row);
     }
   }
+  m_lodDirtyTop = 0;
+  m_lodDirtyBottom = m_lodSize.y;
+  if (m_lodQuad.empty()) {
+    m_lodQuad.add(-1);
+  }
+  m_lodStale = false;
+}
+
+void View::updateLevelOfDetailBlock(int blockCol, int blockRow) {
+  auto &board{m_model.board()};
+  auto firstCol{blockCol * m_lodBlock};
+  auto firstRow{blockRow * m_lodBlock};
+  auto lastCol{std::min(firstCol + m_lodBlock, board.width())};
+  auto lastRow{std::min(firstRow + m_lodBlock, board.height())};
+  auto priority{0};
+  for (auto row = firstRow; row < lastRow; row++) {
+    for (auto col = firstCol; col < lastCol; col++) {
+      priority = std::max(priority, lodPriority(board.cell(col, row)));
+    }
+  }
+  auto color{f_lodColors[priority]};
+  auto pixel{m_lodPixels.data() +
+             (static_cast<std::size_t>(blockRow) * m_lodSize.x + blockCol) *
+                 4};
+  pixel[0] = color.r;
+  pixel[1] = color.g;
+  pixel[2] = color.b;
+  pixel[3] = color.a;
+  m_lodDirtyTop = std::min(m_lodDirtyTop, blockRow);
+  m_lodDirtyBottom = std::max(m_lodDirtyBottom, blockRow + 1);
+}
+
+void View::drawProfiler() {
+  if (!m_profiler || !m_profilerVisible) {
+    return;
+  }
+  if (m_profiler->frames() >= m_profilerRefreshFrame) {
+    char content[f_profilerTextCapacity];
+    auto length{std::snprintf(content, sizeof content, "%-14s %8s %8s %8s\n",
+                              "ms", "min", "avg", "p99")};
+    for (std::size_t i = 0; i < FrameProfiler::stagesCount; i++) {
+      auto stage{static_cast<FrameProfiler::Stage>(i)};
+      auto statistics{m_profiler->statistics(stage)};
+      length += std::snprintf(
+          content + length, sizeof content - static_cast<std::size_t>(length),
+          "%-14s %8.3f %8.3f %8.3f\n", FrameProfiler::stageName(stage),
+          statistics.minMs, statistics.avgMs, statistics.p99Ms);
+    }
+    m_profilerText.setString(content);
+    auto bounds{m_profilerText.getGlobalBounds()};
+    m_profilerQuads.clear();
+    m_profilerQuads.setQuad(
+        m_profilerQuads.add(-1),
+        {bounds.left - f_profilerMargin, bounds.top - f_profilerMargin,
+         bounds.width + 2 * f_profilerMargin,
+         bounds.height + 2 * f_profilerMargin},
+        f_profilerBackgroundColor, textureRect(ButtonIcon::None));
+    m_profilerRefreshFrame = m_profiler->frames() + f_profilerRefreshFrames;
+  }
+  m_profilerQuads.draw(m_target, &m_atlas.texture());
+  m_target.draw(m_profilerText);
+}
+
+void View::runStage(FrameProfiler::Stage stage, void (View::*draw)()) {
+  FrameProfiler::Scope scope{activeProfiler(), stage};
+  (this->*draw)();
 }
 
 void View::drawMenu() {
-  auto frame{
-      makeButtonArea({f_menuLeftMargin, 0.}, f_buttonOutlineThickness, 30)};
-  frame.setFillColor(f_menuFrameColor);
-  frame.setOutlineColor(f_backgroundColor);
-  m_window.draw(frame);
-  drawMenuButton(0, 3, Button::Size, ButtonIcon::Button3Left);
-  drawMenuButton(3, 11, Button::None, ButtonIcon::Button11Middle);
-  drawMenuDisplay(11, 3, std::to_string(m_model.minesCount()));
-  drawMenuButton(14, 2, Button::Restart, ButtonIcon::Button2Middle);
-  drawMenuButton(16, 13, Button::None, ButtonIcon::Button13Middle);
-  drawMenuDisplay(16, 3, formattedTime(m_model.timeInSeconds()));
-  drawMenuButton(29, 1, Button::Quit, ButtonIcon::Button1Right);
-}
-
-void View::drawCellButton(int col, int row) {
-  auto pos{cellButtonPosition(col, row)};
-  auto area{makeButtonArea(pos, 1, f_buttonOutlineThickness)};
-  area.setSize(cellButtonSize() - sf::Vector2f{2.f * f_buttonOutlineThickness,
-                                               2.f * f_buttonOutlineThickness});
-  auto &cell{m_model.cells()[col][row]};
-  auto status{cellButtonStatus(area, cell)};
-  if (status != ButtonStatus::Pressed) {
-    area.setTexture(&m_icons.at(ButtonIcon::ButtonStandard));
-  }
-  area.setFillColor(buttonColor(status));
-  if (cell.triggered) {
-    area.setFillColor(f_cellMineTriggeredColor);
-  } else if (cell.status == Cell::Status::MarkedAsMine &&
-             cell.type != Cell::Type::Mine &&
-             m_model.status() == Model::Status::Finished) {
-    area.setFillColor(f_cellFalseFlagColor);
+  m_menuQuads.clear();
+  addMenuButton(f_sizeButtonCol, f_sizeButtonWidth, Button::Size,
+                ButtonIcon::Button3Left);
+  addMenuButton(3, 11, Button::None, ButtonIcon::Button11Middle);
+  addMenuDisplay(m_minesLabel);
+  addMenuButton(f_restartButtonCol, f_restartButtonWidth, Button::Restart,
+                ButtonIcon::Button2Middle);
+  addMenuButton(16, 13, Button::None, ButtonIcon::Button13Middle);
+  addMenuDisplay(m_timeLabel);
+  addMenuButton(f_quitButtonCol, f_quitButtonWidth, Button::Quit,
+                ButtonIcon::Button1Right);
+  m_menuQuads.draw(m_target, &m_atlas.texture());
+  updateLabels();
+  m_target.draw(m_sizeLabel.text);
+  m_target.draw(m_minesLabel.text);
+  m_target.draw(m_timeLabel.text);
+}
+
+void View::updateCellQuads(int index, const sf::Vector2f &pos,
+                           const CellLook &look) {
+  auto &current{m_cellLooks[index]};
+  auto size{cellButtonSize() - sf::Vector2f{2.f * f_buttonOutlineThickness,
+                                            2.f * f_buttonOutlineThickness}};
+  sf::FloatRect area{pos.x + f_buttonOutlineThickness,
+                     pos.y + f_buttonOutlineThickness, size.x, size.y};
+  auto &backgroundSlot{m_backgroundSlots[index]};
+  if (backgroundSlot < 0) {
+    backgroundSlot = m_cellBackgrounds.add(index);
   }
-  m_window.draw(area);
-  drawIconOnButton(area, cellButtonIcon(cell));
+  m_cellBackgrounds.setQuad(backgroundSlot, area, look.color,
+                            textureRect(look.background));
+  auto &iconSlot{m_iconSlots[index]};
+  if (iconSlot < 0 || current.icon != look.icon) {
+    removeCellIcon(index);
+    if (look.icon != ButtonIcon::None) {
+      iconSlot = m_cellIcons.add(index);
+      m_cellIcons.setQuad(iconSlot, iconArea(area), sf::Color::White,
+                          textureRect(look.icon));
+    }
+  }
+  current = look;
 }
 
-void View::drawMenuButton(int col, int width, Button button, ButtonIcon icon) {
-  auto area{makeButtonArea({f_menuLeftMargin + col * f_buttonSmallWidth, 0},
-                           width, f_buttonOutlineThickness)};
-  auto status{menuButtonStatus(area, button)};
-  area.setFillColor(buttonColor(status));
-  if (status != ButtonStatus::Pressed) {
-    area.setTexture(&m_icons.at(icon));
+void View::removeCellIcon(int index) {
+  auto &slot{m_iconSlots[index]};
+  if (slot < 0) {
+    return;
+  }
+  auto moved{m_cellIcons.remove(slot)};
+  if (moved >= 0) {
+    m_iconSlots[moved] = slot;
   }
-  m_window.draw(area);
+  slot = -1;
+}
+
+void View::addMenuButton(int col, int width, Button button, ButtonIcon icon) {
+  auto area{menuRect(col, width, f_buttonOutlineThickness)};
+  auto status{menuButtonStatus(button)};
+  addMenuQuad(area, buttonColor(status),
+              status == ButtonStatus::Pressed ? ButtonIcon::None : icon);
   switch (button) {
   case Button::Quit:
-    return drawIconOnButton(area, ButtonIcon::Quit);
+    return addMenuQuad(iconArea(area), sf::Color::White, ButtonIcon::Quit);
   case Button::Restart:
     if (m_model.status() == Model::Status::Finished && !m_model.success()) {
-      return drawIconOnButton(area, ButtonIcon::Sad);
+      return addMenuQuad(iconArea(area), sf::Color::White, ButtonIcon::Sad);
     }
-    return drawIconOnButton(area, ButtonIcon::Happy);
+    return addMenuQuad(iconArea(area), sf::Color::White, ButtonIcon::Happy);
   default:
-    return drawTextOnButton(area, buttonContent(button));
+    return;
   }
 }
 
-void View::drawMenuDisplay(int col, int width, const std::string &content) {
-  auto area{makeButtonArea({f_menuLeftMargin + col * f_buttonSmallWidth, 0},
-                           width, f_displayOutlineThickness)};
-  area.setFillColor(f_menuDisplayColor);
-  m_window.draw(area);
-  drawTextOnButton(area, content);
+void View::addMenuDisplay(const Label &label) {
+  addMenuQuad(label.area, f_menuDisplayColor, ButtonIcon::None);
 }
 
-void View::drawIconOnButton(ButtonArea &area, ButtonIcon icon) {
-  if (icon == ButtonIcon::None) {
+void View::addMenuQuad(const sf::FloatRect &rect, const sf::Color &color,
+                       ButtonIcon icon) {
+  m_menuQuads.setQuad(m_menuQuads.add(-1), rect, color, textureRect(icon));
+}
+
+void View::initLabel(Label &label, const sf::FloatRect &area) {
+  label.text.setFont(m_font);
+  label.text.setCharacterSize(f_fontSize);
+  label.text.setStyle(sf::Text::Bold);
+  label.text.setFillColor(f_fontColor);
+  label.area = area;
+}
+
+void View::updateLabels() {
+  char content[Label::capacity];
+  std::snprintf(content, sizeof content, "%dx%d%s", m_model.width(),
+                m_model.height(), m_model.noGuessFallback() ? "?" : "");
+  setLabel(m_sizeLabel, content);
+  std::snprintf(content, sizeof content, "%d", m_model.minesCount());
+  setLabel(m_minesLabel, content);
+  auto seconds{m_model.timeInSeconds()};
+  std::snprintf(content, sizeof content, "%02d:%02d", seconds / 60,
+                seconds % 60);
+  setLabel(m_timeLabel, content);
+}
+
+void View::setLabel(Label &label, const char *content) {
+  if (std::strncmp(label.content, content, Label::capacity) == 0) {
     return;
   }
-  auto &mask = area;
-  auto areaSize{area.getSize()};
-  auto maskSize{areaSize * f_iconSize};
-  mask.setSize(maskSize);
-  auto &pos{mask.getPosition()};
-  mask.setPosition(pos.x + (areaSize.x - maskSize.x) * .5f,
-                   pos.y + (areaSize.y - maskSize.y) * .5f);
-  mask.setFillColor(sf::Color::White);
-  mask.setTexture(&m_icons.at(icon));
-  m_window.draw(mask);
-}
-
-void View::drawTextOnButton(ButtonArea &area, const std::string &content) {
-  sf::Text text{content, m_font};
-  text.setCharacterSize(f_fontSize);
-  text.setStyle(sf::Text::Bold);
-  auto &pos{area.getPosition()};
-  auto &size{area.getSize()};
-  text.setPosition(pos.x + (size.x - text.getLocalBounds().width) * .5f,
-                   pos.y + (size.y - text.getLocalBounds().height) * .5f -
-                       +f_menuButtonTextVOffset);
-  text.setFillColor(f_fontColor);
-  m_window.draw(text);
+  std::snprintf(label.content, Label::capacity, "%s", content);
+  label.text.setString(content);
+  auto bounds{label.text.getLocalBounds()};
+  label.text.setPosition(
+      label.area.left + (label.area.width - bounds.width) * .5f,
+      label.area.top + (label.area.height - bounds.height) * .5f -
+          f_menuButtonTextVOffset);
 }
 
 void View::scaleWindow() {
-  auto view{m_window.getView()};
+  auto view{m_target.getView()};
   view.setSize(f_defaultWindowWidth, f_defaultWindowHeight);
   view.setCenter(f_defaultWindowWidth * .5f, f_defaultWindowHeight * .5f);
-  m_window.setView(view);
+  m_target.setView(view);
+}
+
+void View::display() {
+  if (m_window) {
+    m_window->display();
+  } else if (m_texture) {
+    m_texture->display();
+  }
 }
 
-View::ButtonArea View::makeButtonArea(const sf::Vector2f &pos, int width,
-                                      float outlineThickness) const {
-  ButtonArea rect{{width * f_buttonSmallWidth - 2 * outlineThickness,
-                   f_buttonHeight - 2 * outlineThickness}};
-  rect.setPosition(pos.x + outlineThickness, pos.y + outlineThickness);
-  rect.setOutlineThickness(outlineThickness);
-  rect.setOutlineColor(f_buttonOutlineColor);
-  return rect;
+sf::FloatRect View::menuRect(int col, int width,
+                             float outlineThickness) const {
+  return {f_menuLeftMargin + col * f_buttonSmallWidth + outlineThickness,
+          outlineThickness, width * f_buttonSmallWidth - 2 * outlineThickness,
+          f_buttonHeight - 2 * outlineThickness};
+}
+
+sf::FloatRect View::iconArea(const sf::FloatRect &area) const {
+  auto width{area.width * f_iconSize};
+  auto height{area.height * f_iconSize};
+  return {area.left + (area.width - width) * .5f,
+          area.top + (area.height - height) * .5f, width, height};
 }
 
 sf::Color View::buttonColor(ButtonStatus status) const {
@@ -274,9 +642,16 @@ sf::Color View::buttonColor(ButtonStatus status) const {
 }
 
 sf::Vector2f View::cellButtonSize() const {
-  auto width{f_buttonSmallWidth * (m_zoomLevel / f_zoomMinLevel)};
-  auto height{f_buttonHeight * (m_zoomLevel / f_zoomMinLevel)};
-  return {width, height};
+  auto scale{boardScale() * m_zoomLevel / f_zoomMinLevel};
+  return {f_buttonSmallWidth * scale, f_buttonHeight * scale};
+}
+
+float View::boardScale() const {
+  auto hScale{f_boardMaxWidth /
+              (f_buttonSmallWidth * static_cast<float>(m_model.width()))};
+  auto vScale{f_boardMaxHeight /
+              (f_buttonHeight * static_cast<float>(m_model.height()))};
+  return std::min({1.f, hScale, vScale});
 }
 
 sf::Vector2f View::cellButtonPosition(int col, int row) const {
@@ -293,11 +668,61 @@ sf::Vector2f View::cellButtonPosition(int col, int row) const {
           topLeftCellVPos + static_cast<float>(row) * cellSize.y};
 }
 
-View::ButtonStatus View::menuButtonStatus(const ButtonArea &area,
-                                          Button button) {
-  auto status{buttonStatus(area)};
-  if (status != ButtonStatus::Released) {
-    m_buttonUnderMouse = button;
+sf::IntRect View::visibleCells() const {
+  auto origin{cellButtonPosition(0, 0) - m_camera};
+  auto size{cellButtonSize()};
+  auto first = [](float from, float cellSize, int count) {
+    return std::clamp(static_cast<int>(std::floor(from / cellSize)), 0, count);
+  };
+  auto last = [](float to, float cellSize, int count) {
+    return std::clamp(static_cast<int>(std::ceil(to / cellSize)), 0, count);
+  };
+  auto left{first(-origin.x, size.x, m_model.width())};
+  auto top{first(f_buttonHeight - origin.y, size.y, m_model.height())};
+  auto right{last(f_defaultWindowWidth - origin.x, size.x, m_model.width())};
+  auto bottom{
+      last(f_defaultWindowHeight - origin.y, size.y, m_model.height())};
+  return {left, top, right - left, bottom - top};
+}
+
+sf::View View::boardView() const {
+  auto width{static_cast<float>(f_defaultWindowWidth)};
+  auto height{static_cast<float>(f_defaultWindowHeight)};
+  sf::View view{{m_camera.x, f_buttonHeight + m_camera.y, width,
+                 height - f_buttonHeight}};
+  view.setViewport(
+      {0.f, f_buttonHeight / height, 1.f, 1.f - f_buttonHeight / height});
+  return view;
+}
+
+void View::setZoomLevel(float level) {
+  auto ratio{level / m_zoomLevel};
+  m_zoomLevel = level;
+  m_camera *= ratio;
+  clampCamera();
+  invalidate();
+}
+
+void View::clampCamera() {
+  m_zoomLevel = std::min(m_zoomLevel, f_zoomMinLevel / boardScale());
+  auto size{cellButtonSize()};
+  auto gridWidth{size.x * static_cast<float>(m_model.width())};
+  auto gridHeight{size.y * static_cast<float>(m_model.height())};
+  auto limitX{
+      std::max(0.f, (gridWidth - static_cast<float>(f_defaultWindowWidth)) *
+                        .5f)};
+  auto limitY{std::max(0.f, (gridHeight + f_buttonHeight -
+                             static_cast<float>(f_defaultWindowHeight)) *
+                                .5f)};
+  m_camera.x = std::clamp(m_camera.x, -limitX, limitX);
+  m_camera.y = std::clamp(m_camera.y, -limitY, limitY);
+}
+
+View::ButtonStatus View::menuButtonStatus(Button button) const {
+  auto status{ButtonStatus::Released};
+  if (m_hover.button == button) {
+    status = m_hover.pressed ? ButtonStatus::Pressed
+                             : ButtonStatus::Highlighted;
   }
   switch (button) {
   case Button::Size:
@@ -314,16 +739,12 @@ View::ButtonStatus View::menuButtonStatus(const ButtonArea &area,
   return status;
 }
 
-View::ButtonStatus View::cellButtonStatus(const ButtonArea &area,
-                                          const Cell &cell) {
-  auto status{buttonStatus(area)};
-  if (status != ButtonStatus::Released) {
-    m_cellUnderMouse = {cell.col, cell.row};
-  }
+View::ButtonStatus View::cellButtonStatus(const Cell &cell,
+                                          ButtonStatus status) const {
   if (m_model.status() == Model::Status::Finished) {
     status = ButtonStatus::Released;
   }
-  switch (cell.status) {
+  switch (cell.status()) {
   case Cell::Status::MarkedAsMine:
     status = ButtonStatus::Released;
     break;
@@ -339,51 +760,90 @@ View::ButtonStatus View::cellButtonStatus(const ButtonArea &area,
   return status;
 }
 
-View::ButtonStatus View::buttonStatus(const ButtonArea &area) const {
-  auto isMouseHoveringButton{area.getGlobalBounds().contains(
-      m_window.mapPixelToCoords(sf::Mouse::getPosition(m_window)))};
-  auto isMousePressed{sf::Mouse::isButtonPressed(sf::Mouse::Left)};
-  if (isMouseHoveringButton) {
-    if (isMousePressed) {
-      return ButtonStatus::Pressed;
-    }
-    return ButtonStatus::Highlighted;
+View::CellLook View::cellLook(int col, int row,
+                              ButtonStatus mouseStatus) const {
+  auto cell{m_model.cell(col, row)};
+  auto status{cellButtonStatus(cell, mouseStatus)};
+  CellLook look{status == ButtonStatus::Pressed ? ButtonIcon::None
+                                                : ButtonIcon::ButtonStandard,
+                cellButtonIcon(cell), buttonColor(status)};
+  if (cell.triggered()) {
+    look.color = f_cellMineTriggeredColor;
+  } else if (cell.status() == Cell::Status::MarkedAsMine &&
+             cell.type() != Cell::Type::Mine &&
+             m_model.status() == Model::Status::Finished) {
+    look.color = f_cellFalseFlagColor;
   }
-  return ButtonStatus::Released;
-};
+  return look;
+}
 
-std::string View::buttonContent(View::Button button) const {
-  switch (button) {
-  case View::Button::Quit:
-    return "Quit";
-  case View::Button::Restart:
-    return "Restart";
-  case View::Button::Size:
-    switch (m_model.size()) {
-    case Model::Size::Size9x9:
-      return "9x9";
-    case Model::Size::Size16x16:
-      return "16x16";
-    default:
-    case Model::Size::Size30x16:
-      return "30x16";
-    }
-  default:
-    return "";
+std::optional<std::pair<int, int>>
+View::cellAt(const sf::Vector2f &coords) const {
+  if (coords.y < f_buttonHeight) {
+    return {};
   }
+  auto origin{cellButtonPosition(0, 0) - m_camera};
+  auto size{cellButtonSize()};
+  auto col{static_cast<int>(std::floor((coords.x - origin.x) / size.x))};
+  auto row{static_cast<int>(std::floor((coords.y - origin.y) / size.y))};
+  if (!m_model.board().contains(col, row)) {
+    return {};
+  }
+  return {{col, row}};
+}
+
+View::Hover View::hover() const {
+  if (!m_window) {
+    return {};
+  }
+  auto coords{m_target.mapPixelToCoords(sf::Mouse::getPosition(*m_window))};
+  return {cellAt(coords), buttonAt(coords),
+          sf::Mouse::isButtonPressed(sf::Mouse::Left)};
+}
+
+View::Button View::buttonAt(const sf::Vector2f &coords) const {
+  if (coords.y < 0.f || coords.y >= f_buttonHeight) {
+    return Button::None;
+  }
+  auto col{static_cast<int>(
+      std::floor((coords.x - f_menuLeftMargin) / f_buttonSmallWidth))};
+  auto within = [col](int first, int width) {
+    return col >= first && col < first + width;
+  };
+  if (within(f_sizeButtonCol, f_sizeButtonWidth)) {
+    return Button::Size;
+  }
+  if (within(f_restartButtonCol, f_restartButtonWidth)) {
+    return Button::Restart;
+  }
+  if (within(f_quitButtonCol, f_quitButtonWidth)) {
+    return Button::Quit;
+  }
+  return Button::None;
+}
+
+const sf::IntRect &View::iconRect(ButtonIcon icon) const {
+  if (icon == ButtonIcon::None) {
+    return m_atlas.whiteRect();
+  }
+  return m_atlas.rect(static_cast<std::size_t>(icon));
+}
+
+sf::FloatRect View::textureRect(ButtonIcon icon) const {
+  return sf::FloatRect{iconRect(icon)};
 }
 
 View::ButtonIcon View::cellButtonIcon(const Cell &cell) const {
-  switch (cell.status) {
+  switch (cell.status()) {
   case Cell::Status::MarkedAsMine:
     return ButtonIcon::Flag;
   case Cell::Status::MarkedAsSuspect:
     return ButtonIcon::QuestionMark;
   case Cell::Status::Revealed:
-    if (cell.type == Cell::Type::Mine) {
+    if (cell.type() == Cell::Type::Mine) {
       return ButtonIcon::Mine;
     }
-    switch (cell.neighbourMinesCount) {
+    switch (cell.neighbourMinesCount()) {
     case 1:
       return ButtonIcon::One;
     case 2:
@@ -1,30 +1,48 @@
 #ifndef MINESWEEPER_VIEW_HPP
 #define MINESWEEPER_VIEW_HPP
 
-#include <SFML/Graphics/RectangleShape.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <optional>
+#include <vector>
 
+#include "FrameProfiler.hpp"
 #include "Model.hpp"
+#include "QuadBatch.hpp"
+#include "TextureAtlas.hpp"
 
-class View {
+class View : public Model::Listener {
 public:
   enum class Button { Quit, Restart, Size, None };
+  enum class Direction { Left, Right, Up, Down };
 
   View(sf::RenderWindow &window, Model &model);
+  View(sf::RenderTexture &texture, Model &model);
+  View(const View &) = delete;
+  View &operator=(const View &) = delete;
+  ~View() override;
 
-  Button buttonUnderMouse() const;
-  std::optional<std::pair<int, int>> cellUnderMouse() const;
+  Button buttonAtPixel(const sf::Vector2i &pixel) const;
+  std::optional<std::pair<int, int>>
+  cellAtPixel(const sf::Vector2i &pixel) const;
 
+  bool needsUpdate() const;
+
+  void onChanges(const Model::Changes &changes) override;
   void update();
+  FrameProfiler *activeProfiler() const;
+  void setProfiler(FrameProfiler *profiler, bool recording);
+  void toggleProfiler();
+  void invalidate();
   void zoomIn();
   void zoomOut();
+  void pan(const sf::Vector2f &offset);
+  void pan(Direction direction);
+  void drag(const sf::Vector2i &from, const sf::Vector2i &to);
   void closeWindow();
 
 private:
-  using ButtonArea = sf::RectangleShape;
-
   enum class ButtonStatus { Released, Highlighted, Pressed };
 
   enum class ButtonIcon {
@@ -51,35 +69,125 @@ private:
     None
   };
 
+  struct CellLook {
+    ButtonIcon background{ButtonIcon::None};
+    ButtonIcon icon{ButtonIcon::None};
+    sf::Color color{};
+
+    bool operator==(const CellLook &other) const {
+      return background == other.background && icon == other.icon &&
+             color == other.color;
+    }
+  };
+
+  struct Label {
+    static constexpr std::size_t capacity{16};
+
+    sf::Text text{};
+    sf::FloatRect area{};
+    char content[capacity]{};
+  };
+
+  struct Hover {
+    std::optional<std::pair<int, int>> cell{};
+    Button button{Button::None};
+    bool pressed{false};
+
+    bool operator==(const Hover &other) const {
+      return cell == other.cell && button == other.button &&
+             pressed == other.pressed;
+    }
+  };
+
+  View(sf::RenderTarget &target, sf::RenderWindow *window,
+       sf::RenderTexture *texture, Model &model);
+
   void loadResources();
   void drawBackground();
   void drawCells();
+  void updateCell(int col, int row, ButtonStatus mouseStatus, bool force);
+  void drawLevelOfDetail();
+  void updateLevelOfDetail();
+  void rebuildLevelOfDetail();
+  void updateLevelOfDetailBlock(int blockCol, int blockRow);
   void drawMenu();
-  void drawCellButton(int col, int row);
-  void drawMenuButton(int col, int width, Button button, ButtonIcon icon);
-  void drawMenuDisplay(int col, int width, const std::string &content);
-  void drawIconOnButton(ButtonArea &button, ButtonIcon icon);
-  void drawTextOnButton(ButtonArea &button, const std::string &content);
+  void drawProfiler();
+  void runStage(FrameProfiler::Stage stage, void (View::*draw)());
+  void updateCellQuads(int index, const sf::Vector2f &pos,
+                       const CellLook &look);
+  void removeCellIcon(int index);
+  void addMenuButton(int col, int width, Button button, ButtonIcon icon);
+  void addMenuDisplay(const Label &label);
+  void addMenuQuad(const sf::FloatRect &rect, const sf::Color &color,
+                   ButtonIcon icon);
+  void initLabel(Label &label, const sf::FloatRect &area);
+  void updateLabels();
+  void setLabel(Label &label, const char *content);
   void scaleWindow();
+  void display();
 
-  ButtonArea makeButtonArea(const sf::Vector2f &pos, int width,
-                            float outlineThickness) const;
+  sf::FloatRect menuRect(int col, int width, float outlineThickness) const;
+  sf::FloatRect iconArea(const sf::FloatRect &area) const;
   sf::Color buttonColor(ButtonStatus status) const;
   sf::Vector2f cellButtonSize() const;
+  float boardScale() const;
   sf::Vector2f cellButtonPosition(int col, int row) const;
-  ButtonStatus buttonStatus(const ButtonArea &area) const;
-  ButtonStatus menuButtonStatus(const ButtonArea &area, Button button);
-  ButtonStatus cellButtonStatus(const ButtonArea &area, const Cell &cell);
-  std::string buttonContent(View::Button button) const;
+  ButtonStatus menuButtonStatus(Button button) const;
+  ButtonStatus cellButtonStatus(const Cell &cell, ButtonStatus status) const;
+  CellLook cellLook(int col, int row, ButtonStatus mouseStatus) const;
+  std::optional<std::pair<int, int>> cellAt(const sf::Vector2f &coords) const;
+  sf::IntRect visibleCells() const;
+  sf::View boardView() const;
+  void setZoomLevel(float level);
+  void clampCamera();
+  Hover hover() const;
+  Button buttonAt(const sf::Vector2f &coords) const;
+  const sf::IntRect &iconRect(ButtonIcon icon) const;
+  sf::FloatRect textureRect(ButtonIcon icon) const;
   ButtonIcon cellButtonIcon(const Cell &cell) const;
 
   Model &m_model;
-  sf::RenderWindow &m_window;
+  sf::RenderTarget &m_target;
+  sf::RenderWindow *m_window;
+  sf::RenderTexture *m_texture;
   sf::Font m_font;
-  std::map<ButtonIcon, sf::Texture> m_icons;
-  Button m_buttonUnderMouse;
-  std::optional<std::pair<int, int>> m_cellUnderMouse;
+  TextureAtlas m_atlas;
   float m_zoomLevel;
+  QuadBatch m_cellBackgrounds;
+  QuadBatch m_cellIcons;
+  std::vector<CellLook> m_cellLooks;
+  std::vector<int> m_backgroundSlots;
+  std::vector<int> m_iconSlots;
+  sf::Vector2i m_meshBoardSize;
+  sf::Vector2f m_meshCellSize;
+  QuadBatch m_menuQuads;
+  Label m_sizeLabel;
+  Label m_minesLabel;
+  Label m_timeLabel;
+  Hover m_hover;
+  std::uint64_t m_drawnRevision;
+  bool m_invalid;
+  sf::Vector2f m_camera;
+  sf::IntRect m_meshCells;
+  FrameProfiler *m_profiler;
+  bool m_profilerRecording;
+  bool m_profilerVisible;
+  std::size_t m_profilerRefreshFrame;
+  sf::Text m_profilerText;
+  QuadBatch m_profilerQuads;
+  std::vector<int> m_changedCells;
+  bool m_allCellsChanged;
+  bool m_statusChanged;
+  Hover m_meshHover;
+  std::vector<std::uint8_t> m_lodPixels;
+  sf::Texture m_lodTexture;
+  QuadBatch m_lodQuad;
+  sf::Vector2i m_lodBoardSize;
+  sf::Vector2i m_lodSize;
+  int m_lodBlock;
+  int m_lodDirtyTop;
+  int m_lodDirtyBottom;
+  bool m_lodStale;
 };
 
 #endif